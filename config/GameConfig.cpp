@@ -1,6 +1,8 @@
 #include "GameConfig.h"
 #include "GameConfig.h"
 #include <filesystem>
+#include <cstring>
+#include <vector>
 #include <QDebug>
 
 // 获取单例实例
@@ -149,6 +151,45 @@ bool GameConfig::reloadConfig()
     return (result == SI_OK);
 }
 
+// 只重新加载按键绑定
+bool GameConfig::reloadKeyBindings()
+{
+    if (!m_initialized) return false;
+
+    CSimpleIniA ini;
+    ini.SetUnicode();
+    if (ini.LoadFile(m_configFilePath.c_str()) < 0) return false;
+
+    // 先删除旧的按键段（文件中删除的绑定随之恢复默认），再从文件复制
+    CSimpleIniA::TNamesDepend sections;
+    m_ini->GetAllSections(sections);
+    std::vector<std::string> oldSections;
+    for (const auto& section : sections) {
+        if (std::strncmp(section.pItem, "Keys.", 5) == 0) {
+            oldSections.push_back(section.pItem);
+        }
+    }
+    for (const std::string& section : oldSections) {
+        m_ini->Delete(section.c_str(), nullptr);
+    }
+
+    sections.clear();
+    ini.GetAllSections(sections);
+    for (const auto& section : sections) {
+        if (std::strncmp(section.pItem, "Keys.", 5) != 0) continue;
+
+        CSimpleIniA::TNamesDepend keys;
+        ini.GetAllKeys(section.pItem, keys);
+        for (const auto& key : keys) {
+            m_ini->SetValue(section.pItem, key.pItem, ini.GetValue(section.pItem, key.pItem));
+        }
+    }
+
+    m_configData.keyProfile = ini.GetValue("Input", "keyProfile", configData().keyProfile.c_str());
+    m_ini->SetValue("Input", "keyProfile", m_configData.keyProfile.c_str());
+    return true;
+}
+
 // 获取配置文件路径
 std::string GameConfig::getConfigFilePath() const
 {
@@ -170,15 +211,21 @@ void GameConfig::setDefaultConfig()
     m_ini->SetValue("General", "version", default_configData.version.c_str());
     // 方块相关
     m_ini->SetValue("Block", "randomizerType", default_configData.randomizerType.c_str());
+    m_ini->SetLongValue("Block", "previewCount", default_configData.previewCount);
+    m_ini->SetValue("Block", "pieceSet", default_configData.pieceSet.c_str());
     // 游戏引擎相关
     m_ini->SetBoolValue("Engine", "ghostEnabled", default_configData.ghostEnabled);
     m_ini->SetBoolValue("Engine", "canHold", default_configData.canHold);
+    m_ini->SetBoolValue("Engine", "smoothFall", default_configData.smoothFall);
+    m_ini->SetLongValue("Engine", "lineClearDelay", default_configData.lineClearDelay);
+    m_ini->SetBoolValue("Engine", "particleEffects", default_configData.particleEffects);
     m_ini->SetLongValue("Engine", "gameTimerInterval", default_configData.gameTimerInterval);
     // 游戏界面相关
     m_ini->SetLongValue("Field", "width", default_configData.width);
     m_ini->SetLongValue("Field", "height", default_configData.height);
     m_ini->SetLongValue("Field", "cellSize", default_configData.cellSize);
     m_ini->SetLongValue("Field", "widgetCellSize", default_configData.widgetCellSize);
+    m_ini->SetValue("Field", "theme", default_configData.theme.c_str());
     // 窗口相关1
     m_ini->SetLongValue("MainWindow", "MainWindowFixedSizeW", default_configData.MainWindowFixedSizeW);
     m_ini->SetLongValue("MainWindow", "MainWindowFixedSizeH", default_configData.MainWindowFixedSizeH);
@@ -194,6 +241,7 @@ void GameConfig::setDefaultConfig()
     m_ini->SetLongValue("Input", "autoRepeatDelay", default_configData.autoRepeatDelay);
     m_ini->SetLongValue("Input", "addRepeatDelay", default_configData.addRepeatDelay);
     m_ini->SetLongValue("Input", "autoRepeatInterval", default_configData.autoRepeatInterval);
+    m_ini->SetValue("Input", "keyProfile", default_configData.keyProfile.c_str());
     // 分数相关
     m_ini->SetLongValue("Score", "maxHighScores", default_configData.maxHighScores);
 }
@@ -204,15 +252,21 @@ void GameConfig::updateIniData()
     m_ini->SetValue("General", "version", m_configData.version.c_str());
     // 方块相关
     m_ini->SetValue("Block", "randomizerType", m_configData.randomizerType.c_str());
+    m_ini->SetLongValue("Block", "previewCount", m_configData.previewCount);
+    m_ini->SetValue("Block", "pieceSet", m_configData.pieceSet.c_str());
     // 游戏引擎相关
     m_ini->SetBoolValue("Engine", "ghostEnabled", m_configData.ghostEnabled);
     m_ini->SetBoolValue("Engine", "canHold", m_configData.canHold);
+    m_ini->SetBoolValue("Engine", "smoothFall", m_configData.smoothFall);
+    m_ini->SetLongValue("Engine", "lineClearDelay", m_configData.lineClearDelay);
+    m_ini->SetBoolValue("Engine", "particleEffects", m_configData.particleEffects);
     m_ini->SetLongValue("Engine", "gameTimerInterval", m_configData.gameTimerInterval);
     // 游戏界面相关
     m_ini->SetLongValue("Field", "width", m_configData.width);
     m_ini->SetLongValue("Field", "height", m_configData.height);
     m_ini->SetLongValue("Field", "cellSize", m_configData.cellSize);
     m_ini->SetLongValue("Field", "widgetCellSize", m_configData.widgetCellSize);
+    m_ini->SetValue("Field", "theme", m_configData.theme.c_str());
     // 窗口相关1
     m_ini->SetLongValue("MainWindow", "MainWindowFixedSizeW", m_configData.MainWindowFixedSizeW);
     m_ini->SetLongValue("MainWindow", "MainWindowFixedSizeH", m_configData.MainWindowFixedSizeH);
@@ -228,6 +282,7 @@ void GameConfig::updateIniData()
     m_ini->SetLongValue("Input", "autoRepeatDelay", m_configData.autoRepeatDelay);
     m_ini->SetLongValue("Input", "addRepeatDelay", m_configData.addRepeatDelay);
     m_ini->SetLongValue("Input", "autoRepeatInterval", m_configData.autoRepeatInterval);
+    m_ini->SetValue("Input", "keyProfile", m_configData.keyProfile.c_str());
     // 分数相关
     m_ini->SetLongValue("Score", "maxHighScores", m_configData.maxHighScores);
 }
@@ -238,14 +293,20 @@ void GameConfig::updateConfigData()
     m_configData.version = getStringValue("General", "version", m_configData.version);
 
     m_configData.randomizerType = getStringValue("Block", "randomizerType", m_configData.randomizerType);
+    m_configData.previewCount = getIntValue("Block", "previewCount", m_configData.previewCount);
+    m_configData.pieceSet = getStringValue("Block", "pieceSet", m_configData.pieceSet);
     m_configData.ghostEnabled = getBoolValue("Engine", "ghostEnabled", m_configData.ghostEnabled);
     m_configData.canHold = getBoolValue("Engine", "canHold", m_configData.canHold);
+    m_configData.smoothFall = getBoolValue("Engine", "smoothFall", m_configData.smoothFall);
+    m_configData.lineClearDelay = getIntValue("Engine", "lineClearDelay", m_configData.lineClearDelay);
+    m_configData.particleEffects = getBoolValue("Engine", "particleEffects", m_configData.particleEffects);
     m_configData.gameTimerInterval = getIntValue("Engine", "gameTimerInterval", m_configData.gameTimerInterval);
 
     m_configData.width = getIntValue("Field", "width", m_configData.width);
     m_configData.height = getIntValue("Field", "height", m_configData.height);
     m_configData.cellSize = getIntValue("Field", "cellSize", m_configData.cellSize);
     m_configData.widgetCellSize = getIntValue("Field", "widgetCellSize", m_configData.widgetCellSize);
+    m_configData.theme = getStringValue("Field", "theme", m_configData.theme);
 
     m_configData.MainWindowFixedSizeW = getIntValue("MainWindow", "MainWindowFixedSizeW", m_configData.MainWindowFixedSizeW);
     m_configData.MainWindowFixedSizeH = getIntValue("MainWindow", "MainWindowFixedSizeH", m_configData.MainWindowFixedSizeH);
@@ -258,6 +319,7 @@ void GameConfig::updateConfigData()
     m_configData.autoRepeatDelay = getIntValue("Input", "autoRepeatDelay", m_configData.autoRepeatDelay);
     m_configData.addRepeatDelay = getIntValue("Input", "addRepeatDelay", m_configData.addRepeatDelay);
     m_configData.autoRepeatInterval = getIntValue("Input", "autoRepeatInterval", m_configData.autoRepeatInterval);
+    m_configData.keyProfile = getStringValue("Input", "keyProfile", m_configData.keyProfile);
 
     m_configData.maxHighScores = getIntValue("Score", "maxHighScores", m_configData.maxHighScores);
 }
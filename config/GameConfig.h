@@ -13,19 +13,26 @@ class GameConfig
         std::string version = "0.0.4";
         // 方块
         std::string randomizerType = "7-bag"; // 随机模式
+        int previewCount = 5;              // 预览队列显示个数(1-6)
+        std::string pieceSet = "standard"; // 方块集合（standard 或数据文件路径）
         // 界面
         int width = 10;                    // 场地宽度
         int height = 20;                   // 场地高度
         int cellSize = 30;                 // 格子大小
         int widgetCellSize = 20;           // 预览窗格格子大小
+        std::string theme = "default";     // 主题（default 或主题数据文件路径）
         // 游戏
         bool ghostEnabled = true;          // 是否开启幽灵方块
         bool canHold = true;               // 是否开启暂存
+        bool smoothFall = true;            // 下落方块按格内进度平滑绘制
+        int lineClearDelay = 0;            // 消行后生成新方块前的等待时间(ms)，0 为不等待
+        bool particleEffects = true;       // 锁定火花和消行碎片粒子效果
         int gameTimerInterval = 16;        // 游戏更新间隔（刷新率）
         // 控制
         int autoRepeatDelay = 100;         // 最短自动重复延迟(ms)
         int addRepeatDelay = 200;          // 自动重复延迟变化量(ms)
-        int autoRepeatInterval = 50;       // 自动重复间隔(ms)
+        int autoRepeatInterval = 50;       // 自动重复间隔(ms)，0 表示充能后直接移到墙边
+        std::string keyProfile = "default"; // 按键方案（对应 [Keys.<方案名>] 段）
         // 分数
         int maxHighScores = 5;             // 高分榜显示个数
         // UI
@@ -89,6 +96,9 @@ public:
     // 重新加载配置文件
     bool reloadConfig();
 
+    // 只重新加载按键绑定（[Input] keyProfile 和所有 [Keys.*] 段），其他设置保持不变
+    bool reloadKeyBindings();
+
     // 将配置数据加载到配置对象中
     void updateIniData();
 
@@ -120,16 +130,23 @@ private:
 #define GAME_CONFIG_DATA        GAME_CONFIG.getConfigData()
 #define GAME_VERSION            GAME_CONFIG_DATA.version
 #define RANDOMIZER_TYPE         GAME_CONFIG_DATA.randomizerType
+#define PREVIEW_COUNT           GAME_CONFIG_DATA.previewCount
+#define PIECE_SET               GAME_CONFIG_DATA.pieceSet
+#define THEME                   GAME_CONFIG_DATA.theme
 #define FIELD_WIDTH             GAME_CONFIG_DATA.width
 #define FIELD_HEIGHT            GAME_CONFIG_DATA.height
 #define FIELD_CELL_SIZE         GAME_CONFIG_DATA.cellSize
 #define WIDGET_CELL_SIZE        GAME_CONFIG_DATA.widgetCellSize
 #define GHOST_BLOCK_ENABLED     GAME_CONFIG_DATA.ghostEnabled
 #define BLOCK_CANHOLD           GAME_CONFIG_DATA.canHold
+#define SMOOTH_FALL             GAME_CONFIG_DATA.smoothFall
+#define LINE_CLEAR_DELAY        GAME_CONFIG_DATA.lineClearDelay
+#define PARTICLE_EFFECTS        GAME_CONFIG_DATA.particleEffects
 #define GAME_TIMER_INTERVAL     GAME_CONFIG_DATA.gameTimerInterval
 #define AUTO_REPEAT_DELAY       GAME_CONFIG_DATA.autoRepeatDelay
 #define ADD_REPEAT_DELAY        GAME_CONFIG_DATA.addRepeatDelay
 #define AUTO_REPEAT_INTERVAL    GAME_CONFIG_DATA.autoRepeatInterval
+#define KEY_PROFILE             GAME_CONFIG_DATA.keyProfile
 #define MAX_HIGH_SCORES         GAME_CONFIG_DATA.maxHighScores
 #define MAINWINDOW_FIXED_SIZEW  GAME_CONFIG_DATA.MainWindowFixedSizeW
 #define MAINWINDOW_FIXED_SIZEH  GAME_CONFIG_DATA.MainWindowFixedSizeH
@@ -10,9 +10,10 @@ struct GameStats {
     int totalPieces;
     QDateTime startTime;
     int gameDuration; // 秒数
+    quint64 seed;     // 方块序列种子，用于复现对局
 
     GameStats() : score(0), level(1), linesCleared(0),
-        currentCombo(0), totalPieces(0), gameDuration(0) {
+        currentCombo(0), totalPieces(0), gameDuration(0), seed(0) {
     }
 
     void reset() {
@@ -22,6 +23,7 @@ struct GameStats {
         currentCombo = 0;
         totalPieces = 0;
         gameDuration = 0;
+        seed = 0;
         startTime = QDateTime();
     }
 };
@@ -1,20 +1,13 @@
 #include "Block.h"
-#include <algorithm>
 #include <qdebug.h>
 
 Block::Block()
-    : m_type(TYPE_COUNT), m_position(0, 0), m_rotation(ROT_0)
+    : m_type(TYPE_NONE), m_piece(nullptr), m_position(0, 0), m_rotation(ROT_0)
 {
-    // 创建一个明确的空方块形状
-    m_shape.name = "Empty";
-    m_shape.pattern = QVector<QVector<bool>>(4, QVector<bool>(4, false));
-    m_shape.color = Qt::black;
-    m_shape.spawnOffsetX = 0;
-    m_shape.spawnOffsetY = 0;
 }
 
-Block::Block(BlockType type, const BlockShape& shape)
-    : m_type(type), m_shape(shape), m_position(0, 0), m_rotation(ROT_0)
+Block::Block(BlockType type, const PieceSet::Piece* piece)
+    : m_type(type), m_piece(piece), m_position(0, 0), m_rotation(ROT_0)
 {
 }
 
@@ -41,16 +34,16 @@ void Block::resetRotation()
 
 QVector<Position> Block::getOccupiedCells() const
 {
-    // 将方块的几何位置转换为坐标
+    // 直接查预计算的旋转表，加上当前位置
     QVector<Position> cells;
-    QVector<QVector<bool>> pattern = getRotatedPattern();
+    if (!m_piece) {
+        return cells;
+    }
 
-    for (int y = 0; y < pattern.size(); ++y) {
-        for (int x = 0; x < pattern[y].size(); ++x) {
-            if (pattern[y][x]) {
-                cells.append(Position(m_position.x + x, m_position.y + y));
-            }
-        }
+    const PieceSet::Rotation& rotation = getRotationData();
+    cells.reserve(rotation.cellCount);
+    for (int i = 0; i < rotation.cellCount; ++i) {
+        cells.append(rotation.cells[i] + m_position);
     }
 
     return cells;
@@ -58,41 +51,18 @@ QVector<Position> Block::getOccupiedCells() const
 
 QRect Block::getBoundingBox() const
 {
-    QVector<Position> cells = getOccupiedCells();
-    if (cells.isEmpty()) {
+    if (!m_piece) {
         return QRect();
     }
 
-    int minX = cells[0].x;
-    int maxX = cells[0].x;
-    int minY = cells[0].y;
-    int maxY = cells[0].y;
-
-    for (const Position& cell : std::as_const(cells)) {
-        minX = std::min(minX, cell.x);
-        maxX = std::max(maxX, cell.x);
-        minY = std::min(minY, cell.y);
-        maxY = std::max(maxY, cell.y);
-    }
-
-    return QRect(minX, minY, maxX - minX + 1, maxY - minY + 1);
+    return getRotationData().bounds.translated(m_position.x, m_position.y);
 }
 
-QVector<QVector<bool>> Block::getRotatedPattern() const
+Position Block::getSpawnPosition(int fieldWidth) const
 {
-    QVector<QVector<bool>> rotated = m_shape.pattern;
-    int size = rotated.size();
-
-    // 根据旋转状态进行矩阵旋转
-    for (int i = 0; i < m_rotation; ++i) {
-        QVector<QVector<bool>> temp(size, QVector<bool>(size, false));
-        for (int y = 0; y < size; ++y) {
-            for (int x = 0; x < size; ++x) {
-                temp[x][size - 1 - y] = rotated[y][x];
-            }
-        }
-        rotated = temp;
+    if (!m_piece) {
+        return Position(fieldWidth / 2, 0);
     }
 
-    return rotated;
+    return Position(fieldWidth / 2 + m_piece->spawnOffsetX, m_piece->spawnOffsetY);
 }
@@ -4,14 +4,16 @@
 #include <QColor>
 #include <QRect>
 #include "Position.h"
+#include "PieceSet.h"
 
 class Block
 {
 public:
-    //方块类型
+    //方块类型（方块集合中的下标，标准集合按以下顺序排列）
     enum BlockType {
+        TYPE_NONE = -1,  // 空方块
         TYPE_I, TYPE_O, TYPE_T, TYPE_S, TYPE_Z, TYPE_J, TYPE_L,
-        TYPE_COUNT
+        TYPE_COUNT       // 标准方块种类数
     };
     //旋转角度
     enum RotationState {
@@ -21,31 +23,20 @@ public:
         ROT_270,  // 270度
         ROT_COUNT
     };
-    //方块结构体
-    struct BlockShape {
-        QString name; // 方块名
-        QVector<QVector<bool>> pattern; // 4x4 矩阵
-        QColor color; // 方块颜色
-        //生成时坐标
-        int spawnOffsetX;
-        int spawnOffsetY;
-        //默认为 0,0
-        BlockShape() : spawnOffsetX(0), spawnOffsetY(0) {}
-    };
 
     Block();
-    explicit Block(BlockType type, const BlockShape& shape);
+    explicit Block(BlockType type, const PieceSet::Piece* piece);
 
     // 属性获取
     BlockType getType() const { return m_type; }
-    const BlockShape& getShape() const { return m_shape; }
+    const PieceSet::Piece* getPiece() const { return m_piece; }
     Position getPosition() const { return m_position; }
     RotationState getRotation() const { return m_rotation; }
-    QColor getColor() const { return m_shape.color; }
-    QString getName() const { return m_shape.name; }
+    QColor getColor() const { return m_piece ? m_piece->color : QColor(Qt::black); }
+    QString getName() const { return m_piece ? m_piece->name : QString("Empty"); }
 
-    // 验证方块类型是否有效
-    bool isValid() const { return m_type >= 0 && m_type < TYPE_COUNT; }
+    // 验证方块是否有效（空方块无效）
+    bool isValid() const { return m_piece != nullptr; }
 
     // 变换操作
     void setPosition(const Position& pos) { m_position = pos; }
@@ -56,16 +47,16 @@ public:
     void resetRotation();
 
     // 几何信息
+    const PieceSet::Rotation& getRotationData() const { return m_piece->rotations[m_rotation]; } // 当前旋转状态的预计算数据（仅对有效方块调用）
     QVector<Position> getOccupiedCells() const;  // 获取各个方块的当前位置坐标
     QRect getBoundingBox() const; // 获取图形边界坐标所在的矩形
+    Position getSpawnPosition(int fieldWidth) const; // 获取在指定宽度场地中的生成位置
 
 private:
-    BlockType m_type;           // 类型
-    BlockShape m_shape;         // 方块
-    Position m_position;        // 位置
-    RotationState m_rotation;   // 角度
-
-    QVector<QVector<bool>> getRotatedPattern() const;  // 方块的几何位置
+    BlockType m_type;                 // 类型
+    const PieceSet::Piece* m_piece;   // 方块定义（指向方块集合中的预计算数据）
+    Position m_position;              // 位置
+    RotationState m_rotation;         // 角度
 };
 
 #endif // BLOCK_H
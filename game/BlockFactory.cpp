@@ -1,147 +1,132 @@
 #include <qdebug.h>
+#include <random>
 #include "BlockFactory.h"
 #include "GameConfig.h"
 
 BlockFactory::BlockFactory(QObject* parent)
     : QObject(parent)
-    , m_randomEngine(std::random_device{}())
+    , m_pieceSet(nullptr)
+    , m_queueHead(0)
+    , m_queueSize(0)
+    , m_seed(0)
 {
-    initializeStandardBlocks();
-    resetBag();
+    initializePieceSet();
+    setSeed(generateSeed());
 }
 
-void BlockFactory::initializeStandardBlocks()
+void BlockFactory::setSeed(quint64 seed)
 {
-    m_standardBlocks.clear();
-
-    // 定义所有标准方块
-    m_standardBlocks[Block::TYPE_I] = createStandardShape(Block::TYPE_I);
-    m_standardBlocks[Block::TYPE_O] = createStandardShape(Block::TYPE_O);
-    m_standardBlocks[Block::TYPE_T] = createStandardShape(Block::TYPE_T);
-    m_standardBlocks[Block::TYPE_S] = createStandardShape(Block::TYPE_S);
-    m_standardBlocks[Block::TYPE_Z] = createStandardShape(Block::TYPE_Z);
-    m_standardBlocks[Block::TYPE_J] = createStandardShape(Block::TYPE_J);
-    m_standardBlocks[Block::TYPE_L] = createStandardShape(Block::TYPE_L);
-
-    // 设置可用方块类型
-    m_availableTypes = {
-        Block::TYPE_I, Block::TYPE_O, Block::TYPE_T,
-        Block::TYPE_S, Block::TYPE_Z, Block::TYPE_J, Block::TYPE_L
-    };
+    // 重新播种并清空袋子，保证相同种子生成相同序列
+    m_seed = seed;
+    m_randomizer.setTypeCount(getPieceCount());
+    m_randomizer.setMode(Randomizer::modeFromString(RANDOMIZER_TYPE));
+    m_randomizer.setSeed(seed);
+
+    // 用新序列重新填充预生成队列
+    m_queueHead = 0;
+    m_queueSize = 0;
+    fillQueue();
 }
 
-Block::BlockShape BlockFactory::createStandardShape(Block::BlockType type)
+quint64 BlockFactory::generateSeed()
 {
-    // 定义好每个方块的形状和其他属性
-    Block::BlockShape shape;
-    switch (type) {
-    case Block::TYPE_I:
-        shape.name = "I";
-        shape.pattern = {
-            {false, false, false, false},
-            {true,  true,  true,  true},
-            {false, false, false, false},
-            {false, false, false, false}
-        };
-        shape.color = QColor(0, 255, 255); // 青色
-        shape.spawnOffsetX = 3;
-        shape.spawnOffsetY = 0;
-        break;
-
-    case Block::TYPE_O:
-        shape.name = "O";
-        shape.pattern = {
-            {true, true},
-            {true, true}
-        };
-        shape.color = QColor(255, 255, 0); // 黄色
-        shape.spawnOffsetX = 4;
-        shape.spawnOffsetY = 0;
-        break;
-
-    case Block::TYPE_T:
-        shape.name = "T";
-        shape.pattern = {
-            {false, true, false},
-            {true,  true, true},
-            {false, false, false}
-        };
-        shape.color = QColor(128, 0, 128); // 紫色
-        shape.spawnOffsetX = 3;
-        shape.spawnOffsetY = 0;
-        break;
-
-    case Block::TYPE_S:
-        shape.name = "S";
-        shape.pattern = {
-            {false, true, true},
-            {true,  true, false},
-            {false, false, false}
-        };
-        shape.color = QColor(0, 255, 0); // 绿色
-        shape.spawnOffsetX = 3;
-        shape.spawnOffsetY = 0;
-        break;
-
-    case Block::TYPE_Z:
-        shape.name = "Z";
-        shape.pattern = {
-            {true,  true, false},
-            {false, true, true},
-            {false, false, false}
-        };
-        shape.color = QColor(255, 0, 0); // 红色
-        shape.spawnOffsetX = 3;
-        shape.spawnOffsetY = 0;
-        break;
-
-    case Block::TYPE_J:
-        shape.name = "J";
-        shape.pattern = {
-            {true,  false, false},
-            {true,  true,  true},
-            {false, false, false}
-        };
-        shape.color = QColor(0, 0, 255); // 蓝色
-        shape.spawnOffsetX = 3;
-        shape.spawnOffsetY = 0;
-        break;
-
-    case Block::TYPE_L:
-        shape.name = "L";
-        shape.pattern = {
-            {false, false, true},
-            {true,  true,  true},
-            {false, false, false}
-        };
-        shape.color = QColor(255, 165, 0); // 橙色
-        shape.spawnOffsetX = 3;
-        shape.spawnOffsetY = 0;
-        break;
-
-    default:
-        break;
-    }
-
-    return shape;
+    std::random_device device;
+    return (static_cast<quint64>(device()) << 32) | device();
 }
 
-Block BlockFactory::createRandomBlock()
+BlockFactory::RandomizerState BlockFactory::getRandomizerState() const
 {
-    Block::BlockType type;
+    RandomizerState state;
+    state.seed = m_seed;
+    state.rng = m_randomizer.getGenerator().getState();
+    state.mode = m_randomizer.getMode();
+    state.pieceSet = m_pieceSetName;
+    for (int i = 0; i < m_randomizer.getRemainingCount(); ++i) {
+        state.bag.append(static_cast<Block::BlockType>(m_randomizer.getRemaining(i)));
+    }
+    for (int i = 0; i < m_queueSize; ++i) {
+        state.queue.append(peek(i));
+    }
+    return state;
+}
 
-    if (RANDOMIZER_TYPE == "7-bag") {
-        type = getNextFrom7Bag();
+bool BlockFactory::setRandomizerState(const RandomizerState& state)
+{
+    // 类型下标只在同一方块集合中有意义，界面的贴图也按当前集合生成，不在运行中切换集合
+    if (state.pieceSet != m_pieceSetName) {
+        qWarning() << "Randomizer state is for piece set" << state.pieceSet << ", current is" << m_pieceSetName;
+        return false;
     }
-    else {
-        type = getNextRandom();
+    if (state.mode != Randomizer::MODE_7BAG && state.mode != Randomizer::MODE_RANDOM) {
+        qWarning() << "Invalid randomizer mode in state:" << state.mode;
+        return false;
     }
 
-    // 验证生成的类型是否有效
-    if (type < 0 || type >= Block::TYPE_COUNT) {
-        qDebug() << "ERROR: Generated invalid block type:" << type << ", falling back to TYPE_I";
-        type = Block::TYPE_I; // 回退到I方块
+    // 先校验全部类型，失败时保持原状态
+    const int pieceCount = getPieceCount();
+    if (state.bag.size() > pieceCount || state.queue.size() > LOOKAHEAD_CAPACITY) {
+        qWarning() << "Randomizer state too large: bag" << state.bag.size() << "queue" << state.queue.size();
+        return false;
+    }
+    quint64 bagTypes = 0;
+    for (Block::BlockType type : state.bag) {
+        if (type < 0 || type >= pieceCount || (bagTypes & (quint64(1) << type))) {
+            qWarning() << "Invalid or duplicate bag type in randomizer state:" << type;
+            return false;
+        }
+        bagTypes |= quint64(1) << type;
+    }
+    for (Block::BlockType type : state.queue) {
+        if (type < 0 || type >= pieceCount) {
+            qWarning() << "Invalid queue type in randomizer state:" << type;
+            return false;
+        }
+    }
+
+    m_seed = state.seed;
+    m_randomizer.setTypeCount(pieceCount);
+    m_randomizer.setMode(state.mode);
+    m_randomizer.getGenerator().setState(state.rng);
+
+    int bag[Randomizer::MAX_TYPES];
+    int bagSize = 0;
+    for (Block::BlockType type : state.bag) {
+        bag[bagSize++] = type;
     }
+    m_randomizer.setRemaining(bag, bagSize);
+
+    m_queueHead = 0;
+    m_queueSize = 0;
+    for (Block::BlockType type : state.queue) {
+        m_queue[m_queueSize++] = type;
+    }
+    fillQueue();
+    return true;
+}
+
+void BlockFactory::initializePieceSet()
+{
+    // 方块形状、旋转表和生成位置均在加载方块集合时预计算
+    m_pieceSetName = QString::fromStdString(PIECE_SET);
+    m_pieceSet = PieceSet::get(m_pieceSetName);
+    if (!m_pieceSet) {
+        qWarning() << "Failed to load piece set" << m_pieceSetName << ", falling back to standard";
+        m_pieceSet = PieceSet::standard();
+        m_pieceSetName = "standard";
+    }
+}
+
+Block BlockFactory::createRandomBlock()
+{
+    if (m_queueSize == 0) {
+        fillQueue();
+    }
+
+    // 从队首取出方块，并在队尾补充一个新方块
+    Block::BlockType type = m_queue[m_queueHead];
+    m_queueHead = (m_queueHead + 1) % LOOKAHEAD_CAPACITY;
+    m_queueSize--;
+    fillQueue();
 
     Block block = createBlock(type);
 
@@ -154,43 +139,84 @@ Block BlockFactory::createRandomBlock()
     return block;
 }
 
-Block BlockFactory::createBlock(Block::BlockType type)
+Block::BlockType BlockFactory::peek(int index) const
 {
-    // 验证请求的类型是否有效
-    if (type < 0 || type >= Block::TYPE_COUNT) {
-        qDebug() << "ERROR: Requested invalid block type:" << type;
-        return Block(); // 返回空方块
+    if (index < 0 || index >= m_queueSize) {
+        qDebug() << "ERROR: Peek index out of range:" << index;
+        return Block::TYPE_NONE;
     }
 
-    if (m_standardBlocks.contains(type)) {
-        Block block(type, m_standardBlocks[type]);
-        return block;
+    return m_queue[(m_queueHead + index) % LOOKAHEAD_CAPACITY];
+}
+
+Block::BlockType BlockFactory::generateType()
+{
+    Block::BlockType type = static_cast<Block::BlockType>(m_randomizer.next());
+
+    // 验证生成的类型是否有效
+    if (type < 0 || type >= getPieceCount()) {
+        qDebug() << "ERROR: Generated invalid block type:" << type << ", falling back to TYPE_I";
+        type = Block::TYPE_I; // 回退到I方块
     }
 
-    qDebug() << "WARNING: Block type not found in standard blocks:" << type;
-    return Block();
+    return type;
+}
+
+void BlockFactory::fillQueue()
+{
+    while (m_queueSize < LOOKAHEAD_CAPACITY) {
+        m_queue[(m_queueHead + m_queueSize) % LOOKAHEAD_CAPACITY] = generateType();
+        m_queueSize++;
+    }
 }
 
-Block::BlockType BlockFactory::getNextFrom7Bag()
+Block BlockFactory::createBlock(Block::BlockType type) const
 {
-    if (m_bag.isEmpty()) {
-        resetBag();
+    // 验证请求的类型是否有效
+    if (type < 0 || type >= getPieceCount()) {
+        qDebug() << "ERROR: Requested invalid block type:" << type;
+        return Block(); // 返回空方块
     }
 
-    Block::BlockType type = m_bag.takeFirst();
-    return type;
+    return Block(type, &m_pieceSet->getPiece(type));
 }
 
-Block::BlockType BlockFactory::getNextRandom()
+QDataStream& operator<<(QDataStream& out, const BlockFactory::RandomizerState& state)
 {
-    std::uniform_int_distribution<int> dist(0, m_availableTypes.size() - 1);
-    int index = dist(m_randomEngine);
-    return m_availableTypes[index];
+    out << state.seed << state.rng << static_cast<qint32>(state.mode) << state.pieceSet;
+    out << static_cast<qint32>(state.bag.size());
+    for (Block::BlockType type : state.bag) {
+        out << static_cast<qint32>(type);
+    }
+    out << static_cast<qint32>(state.queue.size());
+    for (Block::BlockType type : state.queue) {
+        out << static_cast<qint32>(type);
+    }
+    return out;
 }
 
-void BlockFactory::resetBag()
+QDataStream& operator>>(QDataStream& in, BlockFactory::RandomizerState& state)
 {
-    m_bag = m_availableTypes;
-    // 随机打乱袋子
-    std::shuffle(m_bag.begin(), m_bag.end(), m_randomEngine);
+    qint32 mode = 0;
+    in >> state.seed >> state.rng >> mode >> state.pieceSet;
+    state.mode = static_cast<Randomizer::Mode>(mode);
+
+    qint32 bagSize = 0;
+    in >> bagSize;
+    state.bag.clear();
+    for (qint32 i = 0; i < bagSize && in.status() == QDataStream::Ok; ++i) {
+        qint32 type = 0;
+        in >> type;
+        state.bag.append(static_cast<Block::BlockType>(type));
+    }
+
+    qint32 queueSize = 0;
+    in >> queueSize;
+    state.queue.clear();
+    for (qint32 i = 0; i < queueSize && in.status() == QDataStream::Ok; ++i) {
+        qint32 type = 0;
+        in >> type;
+        state.queue.append(static_cast<Block::BlockType>(type));
+    }
+    return in;
 }
@@ -2,43 +2,83 @@
 #define BLOCKFACTORY_H
 #include <QObject>
 #include <QVector>
-#include <QHash>
-#include <random>
+#include <QDataStream>
 #include "Block.h"
+#include "Randomizer.h"
 
 class BlockFactory : public QObject
 {
     Q_OBJECT
 
 public:
+    // 随机化状态（可序列化，用于回放和复制对局）
+    struct RandomizerState {
+        quint64 seed;                   // 初始种子
+        RandomGenerator::State rng;     // 生成器状态
+        Randomizer::Mode mode;          // 随机模式
+        QString pieceSet;               // 方块集合（名称或数据文件路径），类型下标按它解释
+        QVector<Block::BlockType> bag;  // 7-bags模式剩余方块
+        QVector<Block::BlockType> queue;// 预生成队列（按出场顺序）
+
+        RandomizerState() : seed(0), rng(), mode(Randomizer::MODE_7BAG) {}
+    };
+
+    // 预生成队列容量（预览最多6个 + 下一个方块）
+    static constexpr int LOOKAHEAD_CAPACITY = 8;
+
     explicit BlockFactory(QObject* parent = nullptr);
 
     // 方块创建
-    Block createRandomBlock();
-    Block createBlock(Block::BlockType type);
+    Block createRandomBlock();  // 从预生成队列取出下一个方块
+    Block createBlock(Block::BlockType type) const;
+
+    // 预生成队列查看（不影响随机序列），index 为 0 时即下一个方块
+    Block::BlockType peek(int index) const;
+    Block peekBlock(int index) const { return createBlock(peek(index)); }
+
+    // 种子
+    void setSeed(quint64 seed);
+    quint64 getSeed() const { return m_seed; }
+    static quint64 generateSeed();  // 从系统熵源生成新种子
+
+    // 随机化状态读写
+    // 恢复时随机模式随状态切换；方块集合必须与当前集合相同，袋子和队列中的类型必须有效，
+    // 否则不做任何修改并返回 false
+    RandomizerState getRandomizerState() const;
+    bool setRandomizerState(const RandomizerState& state);
+
+    // 方块集合
+    const PieceSet* getPieceSet() const { return m_pieceSet; }
+    const QString& getPieceSetName() const { return m_pieceSetName; }  // 加载时使用的名称或路径
+    int getPieceCount() const { return m_pieceSet->getPieceCount(); }
 
     // 配置
     //void setRandomizerType(const QString& type) { RANDOMIZER_TYPE = type; resetBag(); }
 
 private:
-    // 预定义方块
-    void initializeStandardBlocks();
-    Block::BlockShape createStandardShape(Block::BlockType type);
+    // 按配置加载方块集合
+    void initializePieceSet();
 
     // 随机化算法
-    Block::BlockType getNextFrom7Bag();
-    Block::BlockType getNextRandom();
-    void resetBag();
+    Block::BlockType generateType();    // 按随机模式生成下一个类型
+    void fillQueue();                   // 填满预生成队列
 
     // 成员变量
-    QHash<Block::BlockType, Block::BlockShape> m_standardBlocks;  // 标准方块集合
-    QVector<Block::BlockType> m_availableTypes;                   // 合法方块类型集合
+    const PieceSet* m_pieceSet;         // 当前方块集合
+    QString m_pieceSetName;             // 当前方块集合的名称或路径
 
-    // 随机化状态
-    QVector<Block::BlockType> m_bag;    // 7-bags模式方块队列
+    // 预生成队列（环形缓冲区）
+    Block::BlockType m_queue[LOOKAHEAD_CAPACITY];
+    int m_queueHead;                    // 队首下标
+    int m_queueSize;                    // 当前队列长度
 
     // 随机数生成
-    std::mt19937 m_randomEngine;
+    quint64 m_seed;
+    Randomizer m_randomizer;            // 随机化算法（与分析工具共用）
 };
 
+// 序列化支持
+QDataStream& operator<<(QDataStream& out, const BlockFactory::RandomizerState& state);
+QDataStream& operator>>(QDataStream& in, BlockFactory::RandomizerState& state);
+
 #endif // BLOCKFACTORY_H
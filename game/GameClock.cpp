@@ -0,0 +1,12 @@
+#include <QElapsedTimer>
+#include "GameClock.h"
+
+qint64 GameClock::now()
+{
+    static const QElapsedTimer clock = [] {
+        QElapsedTimer timer;
+        timer.start();
+        return timer;
+    }();
+    return clock.nsecsElapsed();
+}
@@ -0,0 +1,13 @@
+#ifndef GAMECLOCK_H
+#define GAMECLOCK_H
+#include <QtGlobal>
+
+// 游戏时钟：进程内共用的单调时钟（纳秒，从首次使用开始计）
+// 输入时间戳、模拟步进和输入延迟统计都以它为准，不受系统时间调整影响
+class GameClock
+{
+public:
+    static qint64 now();
+};
+
+#endif // GAMECLOCK_H
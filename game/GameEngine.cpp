@@ -1,5 +1,6 @@
 #include <QDebug>
 #include <QDateTime>
+#include <algorithm>
 #include "GameEngine.h"
 #include "GameConfig.h"
 
@@ -7,11 +8,23 @@ GameEngine::GameEngine(QObject* parent)
     : QObject(parent)
     , m_gameState(STATE_STOPPED)
     , m_canHold(BLOCK_CANHOLD)
+    , m_lastTickNs(-1)
     , m_fallProgress(0.0f)
     , m_fastDrop(false)
     , m_fallSpeed(1000)
     , m_fastFallSpeed(50)
     , m_lastUpdateTime(0)
+    , m_lineClearDelayLeft(0)
+    , m_leftHeld(false)
+    , m_rightHeld(false)
+    , m_shiftDirection(0)
+    , m_shiftNextRepeat(0)
+    , m_shiftInterval(0)
+    , m_softDropHeld(false)
+    , m_holdHeld(false)
+    , m_rotateHeld(0)
+    , m_hasFixedSeed(false)
+    , m_fixedSeed(0)
 {
     // 创建方块工厂
     m_blockFactory.reset(new BlockFactory(this));
@@ -19,6 +32,7 @@ GameEngine::GameEngine(QObject* parent)
     // 创建游戏计时器
     m_gameTimer = new QTimer(this);
     connect(m_gameTimer, &QTimer::timeout, this, &GameEngine::updateGame);
+    m_tickClock.start();
 }
 
 GameEngine::~GameEngine()
@@ -35,10 +49,9 @@ bool GameEngine::initialize()
     resetGameStats();
 
     // 初始化Hold方块为一个有效的空方块
-    m_holdBlock = Block(); // 这会创建一个TYPE_COUNT的方块，表示"无Hold方块"
+    m_holdBlock = Block(); // 这会创建一个TYPE_NONE的方块，表示"无Hold方块"
 
-    // 初始化预览方块
-    m_nextBlock = m_blockFactory->createRandomBlock();
+    // 预览方块由方块工厂的预生成队列提供
     emit nextBlockChanged();
 
     return true;
@@ -54,12 +67,22 @@ void GameEngine::startGame()
     m_gameState = STATE_RUNNING;
 
     resetGameStats();
+
+    // 重新播种，预生成队列随之按新序列重新填充
+    quint64 seed = m_hasFixedSeed ? m_fixedSeed : BlockFactory::generateSeed();
+    m_blockFactory->setSeed(seed);
+    m_gameStats.seed = seed;
+
     m_gameField.clearField();
     m_canHold = BLOCK_CANHOLD;
     m_fallProgress = 0.0f;
     m_fallSpeed = 1000;
     m_fastDrop = false;
-    m_lastUpdateTime = QDateTime::currentMSecsSinceEpoch();
+    m_lastUpdateTime = GameClock::now();
+    m_lineClearDelayLeft = 0;
+    m_inputQueue.clear();
+    resetHeldKeys();
+    m_lastTickNs = -1;
 
     // 清除holdblock
     m_holdBlock = Block();
@@ -85,6 +108,7 @@ void GameEngine::pauseGame()
 
     m_gameState = STATE_PAUSED;
     m_gameTimer->stop();
+    resetHeldKeys();
 
     emit gameStateChanged(m_gameState);
 }
@@ -94,7 +118,9 @@ void GameEngine::resumeGame()
     if (m_gameState != STATE_PAUSED) return;
 
     m_gameState = STATE_RUNNING;
-    m_lastUpdateTime = QDateTime::currentMSecsSinceEpoch();
+    m_lastUpdateTime = GameClock::now();
+    m_lastTickNs = -1;
+    resetHeldKeys();
     m_gameTimer->start();
 
     emit gameStateChanged(m_gameState);
@@ -116,13 +142,238 @@ void GameEngine::endGame()
     emit gameStateChanged(m_gameState);
 }
 
+void GameEngine::setSeed(quint64 seed)
+{
+    m_hasFixedSeed = true;
+    m_fixedSeed = seed;
+}
+
+void GameEngine::clearSeed()
+{
+    m_hasFixedSeed = false;
+}
+
+quint64 GameEngine::dailySeed(const QDate& date)
+{
+    // 由日期的儒略日数经 splitmix64 打散得到，与时区和地区设置无关
+    RandomGenerator generator(static_cast<quint64>(date.toJulianDay()));
+    return generator();
+}
+
+QVector<Block> GameEngine::getPreviewBlocks(int count) const
+{
+    // 队首为下一个方块，预览从第二个开始
+    count = qBound(0, count, BlockFactory::LOOKAHEAD_CAPACITY - 1);
+
+    QVector<Block> blocks;
+    blocks.reserve(count);
+    for (int i = 1; i <= count; ++i) {
+        blocks.append(m_blockFactory->peekBlock(i));
+    }
+    return blocks;
+}
+
 void GameEngine::updateGame()
 {
     if (m_gameState != STATE_RUNNING) return;
 
-    qint64 currentTime = QDateTime::currentMSecsSinceEpoch();
-    qint64 deltaTime = currentTime - m_lastUpdateTime;
-    m_lastUpdateTime = currentTime;
+    // 计时器抖动：实际间隔与设定间隔之差（暂停、开始后的第一次不计）
+    const qint64 tickStart = m_tickClock.nsecsElapsed();
+    if (m_lastTickNs >= 0) {
+        PERF_STATS.record(PerfStats::CHANNEL_TICK_JITTER, qAbs(tickStart - m_lastTickNs - m_gameTimer->interval() * qint64(1000000)));
+    }
+    m_lastTickNs = tickStart;
+
+    advanceTo(GameClock::now());
+
+    PERF_STATS.record(PerfStats::CHANNEL_TICK, m_tickClock.nsecsElapsed() - tickStart);
+}
+
+void GameEngine::queueInput(InputHandler::GameAction action, bool pressed, qint64 timestamp)
+{
+    if (m_gameState != STATE_RUNNING) return;
+
+    m_inputQueue.append(QueuedInput{ action, pressed, timestamp });
+    advanceTo(GameClock::now());
+}
+
+void GameEngine::advanceTo(qint64 time)
+{
+    if (m_gameState != STATE_RUNNING) return;
+
+    // 不同来源的输入可能乱序到达，按时间戳排序（时间戳相同的保持到达顺序）
+    auto byTimestamp = [](const QueuedInput& a, const QueuedInput& b) { return a.timestamp < b.timestamp; };
+    if (!std::is_sorted(m_inputQueue.begin(), m_inputQueue.end(), byTimestamp)) {
+        std::stable_sort(m_inputQueue.begin(), m_inputQueue.end(), byTimestamp);
+    }
+
+    // 先推进到输入的时间戳再应用，输入和下落的先后与实际发生的顺序一致；
+    // 早于上次步进的输入（到达太晚）在当前模拟时间应用
+    int applied = 0;
+    while (applied < m_inputQueue.size() && m_inputQueue[applied].timestamp <= time) {
+        const QueuedInput input = m_inputQueue[applied++];
+        step(qMax(input.timestamp, m_lastUpdateTime));
+        if (m_gameState != STATE_RUNNING) break;
+        applyInput(input);
+        if (m_gameState != STATE_RUNNING) break;
+    }
+
+    // 游戏结束后剩余的输入作废
+    if (m_gameState != STATE_RUNNING) {
+        m_inputQueue.clear();
+        return;
+    }
+    m_inputQueue.remove(0, applied);
+
+    step(time);
+}
+
+void GameEngine::applyInput(const QueuedInput& input)
+{
+    // 横移按下立即移动一格，按住期间的自动重复在模拟步进中计算
+    if (input.action == InputHandler::ACTION_MOVE_LEFT || input.action == InputHandler::ACTION_MOVE_RIGHT) {
+        const int direction = input.action == InputHandler::ACTION_MOVE_LEFT ? -1 : 1;
+        if (input.pressed) {
+            pressShift(direction);
+        } else {
+            releaseShift(direction);
+        }
+        return;
+    }
+
+    // 软下落在按下到释放之间持续，其他操作只在按下时执行一次
+    if (input.action == InputHandler::ACTION_SOFT_DROP) {
+        m_softDropHeld = input.pressed;
+        if (input.pressed) {
+            softDrop();
+        } else {
+            stopSoftDrop();
+        }
+        return;
+    }
+
+    // 记录旋转和暂存键的按住状态，生成新方块时使用
+    if (input.action == InputHandler::ACTION_ROTATE_CW || input.action == InputHandler::ACTION_ROTATE_CCW) {
+        const int direction = input.action == InputHandler::ACTION_ROTATE_CW ? 1 : -1;
+        if (input.pressed) {
+            m_rotateHeld = direction;
+        } else if (m_rotateHeld == direction) {
+            m_rotateHeld = 0;
+        }
+    } else if (input.action == InputHandler::ACTION_HOLD) {
+        m_holdHeld = input.pressed;
+    }
+    if (!input.pressed) return;
+
+    // 消行等待期间没有当前方块，旋转和暂存留到生成新方块时应用
+    if (!m_currentBlock.isValid()) return;
+
+    switch (input.action) {
+    case InputHandler::ACTION_HARD_DROP:
+        hardDrop();
+        break;
+    case InputHandler::ACTION_ROTATE_CW:
+        rotateClockwise();
+        break;
+    case InputHandler::ACTION_ROTATE_CCW:
+        rotateCounterClockwise();
+        break;
+    case InputHandler::ACTION_HOLD:
+        // 本方块已暂存过时保留按键状态，留到下一个方块生成时应用
+        if (m_canHold) {
+            m_holdHeld = false;
+            holdBlock();
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+qint64 GameEngine::shiftDelay() const
+{
+    // 升级后额外延迟随等级缩短，最短为 AUTO_REPEAT_DELAY
+    const int extra = m_gameStats.level > 1 ? qMax(0, ADD_REPEAT_DELAY - 20 * m_gameStats.level) : ADD_REPEAT_DELAY;
+    return (AUTO_REPEAT_DELAY + extra) * qint64(1000000);
+}
+
+void GameEngine::pressShift(int direction)
+{
+    if (direction < 0) {
+        m_leftHeld = true;
+    } else {
+        m_rightHeld = true;
+    }
+
+    // 后按下的方向优先，从按下时刻（当前模拟时间）开始充能
+    if (direction < 0) {
+        moveLeft();
+    } else {
+        moveRight();
+    }
+    m_shiftDirection = direction;
+    m_shiftNextRepeat = m_lastUpdateTime + shiftDelay();
+    m_shiftInterval = qMax(0, AUTO_REPEAT_INTERVAL) * qint64(1000000);
+}
+
+void GameEngine::releaseShift(int direction)
+{
+    if (direction < 0) {
+        m_leftHeld = false;
+    } else {
+        m_rightHeld = false;
+    }
+    if (direction != m_shiftDirection) return;
+
+    // 另一方向仍按住时改为向该方向重新充能（不立即移动）
+    const bool otherHeld = direction < 0 ? m_rightHeld : m_leftHeld;
+    if (otherHeld) {
+        m_shiftDirection = -direction;
+        m_shiftNextRepeat = m_lastUpdateTime + shiftDelay();
+    } else {
+        m_shiftDirection = 0;
+    }
+}
+
+void GameEngine::resetHeldKeys()
+{
+    m_leftHeld = false;
+    m_rightHeld = false;
+    m_shiftDirection = 0;
+    m_softDropHeld = false;
+    m_holdHeld = false;
+    m_rotateHeld = 0;
+}
+
+void GameEngine::step(qint64 time)
+{
+    // 自动重复的横移落在各自的时间点上，先把下落推进到该时间点再移动
+    while (m_shiftDirection != 0 && m_shiftNextRepeat <= time) {
+        advanceGravity(qMax(m_shiftNextRepeat, m_lastUpdateTime));
+        if (m_gameState != STATE_RUNNING) return;
+
+        // 0 ARR：充能完成后每次步进都直接移到墙边（包括之后生成的新方块）
+        if (m_shiftInterval <= 0) {
+            while (m_shiftDirection < 0 ? moveLeft() : moveRight()) {}
+            break;
+        }
+
+        // 被挡住时保持充能，下一次步进再尝试
+        const bool moved = m_shiftDirection < 0 ? moveLeft() : moveRight();
+        if (!moved) {
+            m_shiftNextRepeat = time;
+            break;
+        }
+        m_shiftNextRepeat += m_shiftInterval;
+    }
+
+    advanceGravity(time);
+}
+
+void GameEngine::advanceGravity(qint64 time)
+{
+    const qint64 deltaTime = qMax<qint64>(0, time - m_lastUpdateTime);
+    m_lastUpdateTime = qMax(m_lastUpdateTime, time);
 
     // 更新游戏时间
     if (m_gameStats.startTime.isNull()) {
@@ -131,9 +382,19 @@ void GameEngine::updateGame()
         m_gameStats.gameDuration = m_gameStats.startTime.secsTo(QDateTime::currentDateTime());
     }
 
+    // 消行等待期间没有当前方块，等待结束后生成新方块
+    if (m_lineClearDelayLeft > 0) {
+        m_lineClearDelayLeft -= deltaTime;
+        if (m_lineClearDelayLeft <= 0) {
+            m_lineClearDelayLeft = 0;
+            spawnNewBlock(true);
+        }
+        return;
+    }
+
     // 更新下落进度
     int currentFallSpeed = m_fastDrop ? m_fastFallSpeed : m_fallSpeed;
-    float progressIncrement = static_cast<float>(deltaTime) / currentFallSpeed;
+    float progressIncrement = static_cast<float>(deltaTime) / (currentFallSpeed * 1e6f);
 
     // 更新进度
     m_fallProgress += progressIncrement;
@@ -264,14 +525,8 @@ void GameEngine::holdBlock()
         return;
     }
 
-    // 验证Hold方块类型（如果是第一次使用，它应该是TYPE_COUNT，这是允许的）
-    if (m_holdBlock.getType() != Block::TYPE_COUNT && !m_holdBlock.isValid()) {
-        qDebug() << "ERROR: Hold block has invalid type!" << m_holdBlock.getType();
-        return;
-    }
-
-    // 检查Hold方块是否为空（TYPE_COUNT表示空）
-    if (m_holdBlock.getType() == Block::TYPE_COUNT) {
+    // 检查Hold方块是否为空（TYPE_NONE表示空）
+    if (!m_holdBlock.isValid()) {
         // 第一次使用Hold - 存储当前方块并生成新方块
 
         m_holdBlock = m_currentBlock;
@@ -294,8 +549,9 @@ void GameEngine::holdBlock()
         m_holdBlock.resetRotation();
 
         // 设置当前方块的位置（从顶部重新开始下落）
-        int spawnX = m_gameField.getWidth() / 2 - 2;
-        m_currentBlock.setPosition(spawnX, 0);
+        Position spawnPos = m_currentBlock.getSpawnPosition(m_gameField.getWidth());
+        int spawnX = spawnPos.x;
+        m_currentBlock.setPosition(spawnPos);
 
         // 验证交换后的方块位置是否有效
         if (!isValidPosition(m_currentBlock)) {
@@ -306,9 +562,9 @@ void GameEngine::holdBlock()
             // 尝试调整位置
             bool foundValidPosition = false;
             for (int offset = -2; offset <= 2; offset++) {
-                m_currentBlock.setPosition(spawnX + offset, 0);
+                m_currentBlock.setPosition(spawnX + offset, spawnPos.y);
                 if (isValidPosition(m_currentBlock)) {
-                    qDebug() << "Adjusted position to: (" << (spawnX + offset) << ", 0)";
+                    qDebug() << "Adjusted position to: (" << (spawnX + offset) << ", " << spawnPos.y << ")";
                     foundValidPosition = true;
                     break;
                 }
@@ -331,30 +587,39 @@ void GameEngine::holdBlock()
     emit holdBlockChanged();
 }
 
-void GameEngine::spawnNewBlock()
+void GameEngine::spawnNewBlock(bool initialActions)
 {
-    m_currentBlock = m_nextBlock;
-    m_nextBlock = m_blockFactory->createRandomBlock();
+    m_currentBlock = m_blockFactory->createRandomBlock();
 
-    // 设置初始位置（场地中央顶部）
-    int spawnX = m_gameField.getWidth() / 2 - 2;
-    m_currentBlock.setPosition(spawnX, 0);
+    // IHS：暂存键按住时新方块直接进入暂存区，换出暂存的方块（暂存区为空时取下一个方块）
+    const bool initialHold = initialActions && m_holdHeld && BLOCK_CANHOLD;
+    if (initialHold) {
+        Block held = m_currentBlock;
+        m_currentBlock = m_holdBlock.isValid() ? m_holdBlock : m_blockFactory->createRandomBlock();
+        m_currentBlock.resetRotation();
+        m_holdBlock = held;
+        m_holdHeld = false;  // 每次按下只暂存一次
+    }
 
-    // 检查游戏结束条件
-    bool canSpawn = true;
-    QVector<Position> cells = m_currentBlock.getOccupiedCells();
+    // 设置初始位置（场地中央顶部，由方块集合预计算）
+    m_currentBlock.setPosition(m_currentBlock.getSpawnPosition(m_gameField.getWidth()));
 
-    for (const Position& cell : std::as_const(cells)) {
-        // 检查新方块是否会与已有方块重叠
-        if (cell.y >= 0 && cell.y < m_gameField.getHeight() &&
-            cell.x >= 0 && cell.x < m_gameField.getWidth()) {
-            if (!m_gameField.isCellEmpty(cell.x, cell.y)) {
-                canSpawn = false;
-                break;
-            }
+    // IRS：旋转键按住时以旋转后的朝向出现，旋转后位置无效时保持原朝向
+    if (initialActions && m_rotateHeld != 0) {
+        Block rotated = m_currentBlock;
+        if (m_rotateHeld > 0) {
+            rotated.rotateClockwise();
+        } else {
+            rotated.rotateCounterClockwise();
+        }
+        if (isValidPosition(rotated)) {
+            m_currentBlock = rotated;
         }
     }
 
+    // 检查游戏结束条件：新方块是否会与已有方块重叠
+    bool canSpawn = isValidPosition(m_currentBlock);
+
     if (!canSpawn) {
         // 游戏结束
         m_gameState = STATE_GAME_OVER;
@@ -362,15 +627,18 @@ void GameEngine::spawnNewBlock()
         return;
     }
 
-    m_canHold = BLOCK_CANHOLD;
+    m_canHold = BLOCK_CANHOLD && !initialHold;
     m_fallProgress = 0.0f;
-    m_fastDrop = false;
+    m_fastDrop = m_softDropHeld;  // 软下落键仍按住时新方块继续快速下落
 
     m_gameStats.totalPieces++;
 
     emit currentBlockChanged();
     emit nextBlockChanged();  // 确保发出下一个方块变化信号
     emit gameStatsUpdated(m_gameStats);
+    if (initialHold) {
+        emit holdBlockChanged();
+    }
 }
 
 void GameEngine::placeCurrentBlock()
@@ -381,7 +649,7 @@ void GameEngine::placeCurrentBlock()
     for (const Position& cell : std::as_const(cells)) {
         if (cell.x >= 0 && cell.x < m_gameField.getWidth() &&
             cell.y >= 0 && cell.y < m_gameField.getHeight()) {
-            m_gameField.setCell(cell.x, cell.y, blockColor);
+            m_gameField.setCell(cell.x, cell.y, blockColor, m_currentBlock.getType());
         }
     }
 }
@@ -390,18 +658,33 @@ void GameEngine::lockCurrentBlock()
 {
     if (m_gameState != STATE_RUNNING) return;
 
+    // 消行等待期间没有可锁定的方块
+    if (!m_currentBlock.isValid()) return;
+
     // 将当前方块放置到场地上
     placeCurrentBlock();
+    emit blockLocked(m_currentBlock);
 
     // 清除完整的行
-    clearCompletedLines();
+    int linesCleared = clearCompletedLines();
 
-    // 生成新方块
-    spawnNewBlock();
+    // 锁定后场地必然变化（无论是否消行），通知界面更新场地图层
+    emit gameFieldChanged();
 
     // 重置下落状态
     m_fallProgress = 0.0f;
     m_fastDrop = false;
+
+    // 配置了消行等待时，先清空当前方块，等待结束后再生成新方块（界面在此期间播放消行动画）
+    if (linesCleared > 0 && LINE_CLEAR_DELAY > 0) {
+        m_currentBlock = Block();
+        m_lineClearDelayLeft = LINE_CLEAR_DELAY * qint64(1000000);
+        emit currentBlockChanged();
+        return;
+    }
+
+    // 生成新方块
+    spawnNewBlock(true);
 }
 
 int GameEngine::clearCompletedLines()
@@ -412,16 +695,58 @@ int GameEngine::clearCompletedLines()
 
     int linesCleared = completeLines.size();
     if (linesCleared > 0) {
+        recordLineClear(completeLines);
         m_gameField.removeLines(completeLines);
         // m_gameField.debugPrintField(); // 打印消除后的场地状态
 
         updateGameStats(linesCleared);
-        emit gameFieldChanged();
+
+        // 行已经移除，动画由界面根据事件中的行内容独立播放，引擎不等待
+        emit linesRemoved(m_lineClearEvent);
     }
 
     return linesCleared;
 }
 
+void GameEngine::recordLineClear(const QVector<int>& lines)
+{
+    LineClearEvent& event = m_lineClearEvent;
+    event.width = qMin(m_gameField.getWidth(), static_cast<int>(GameField::MAX_WIDTH));
+    event.rowCount = 0;
+
+    for (int y : lines) {
+        if (event.rowCount >= LineClearEvent::MAX_ROWS) {
+            qDebug() << "WARNING: Too many cleared lines for line clear event, ignoring line" << y;
+            break;
+        }
+
+        QRgb* cells = event.cells[event.rowCount];
+        qint8* types = event.types[event.rowCount];
+        for (int x = 0; x < event.width; ++x) {
+            const bool empty = m_gameField.isCellEmpty(x, y);
+            cells[x] = empty ? 0 : m_gameField.getCellColor(x, y).rgba();
+            types[x] = static_cast<qint8>(empty ? -1 : m_gameField.getCellType(x, y));
+        }
+        event.rows[event.rowCount++] = y;
+    }
+}
+
+float GameEngine::getInterpolatedFall() const
+{
+    if (m_gameState != STATE_RUNNING) return 0.0f;
+
+    // 方块已落到底（碰撞）时贴齐格子，不向下插值
+    if (!isValidPosition(m_currentBlock, 0, 1)) return 0.0f;
+
+    // 在上次模拟步进的进度基础上，加上距上次步进经过的时间
+    qint64 elapsed = GameClock::now() - m_lastUpdateTime;
+    int currentFallSpeed = m_fastDrop ? m_fastFallSpeed : m_fallSpeed;
+    float progress = m_fallProgress + static_cast<float>(qMax<qint64>(elapsed, 0)) / (currentFallSpeed * 1e6f);
+
+    // 下一次模拟步进前最多显示到下一格之前
+    return qBound(0.0f, progress, 0.999f);
+}
+
 void GameEngine::updateGameStats(int linesCleared)
 {
     m_gameStats.linesCleared += linesCleared;
@@ -461,29 +786,13 @@ void GameEngine::updateLevel()
 
 bool GameEngine::isValidPosition(const Block& block, int dx, int dy) const
 {
-    QVector<Position> cells = block.getOccupiedCells();
-
-    for (const Position& cell : std::as_const(cells)) {
-        int testX = cell.x + dx;
-        int testY = cell.y + dy;
-
-        // 检查左右边界
-        if (testX < 0 || testX >= m_gameField.getWidth()) {
-            return false;
-        }
-
-        // 检查底部边界
-        if (testY >= m_gameField.getHeight()) {
-            return false;
-        }
-
-        // 检查与其他方块的碰撞（只检查场地内的位置）
-        if (testY >= 0 && !m_gameField.isCellEmpty(testX, testY)) {
-            return false;
-        }
+    if (!block.isValid()) {
+        return false;
     }
 
-    return true;
+    // 使用预计算的旋转表和场地行位图做碰撞检测
+    Position pos = block.getPosition();
+    return m_gameField.canPlace(block.getRotationData(), pos.x + dx, pos.y + dy);
 }
 
 void GameEngine::resetGameStats()
@@ -3,10 +3,15 @@
 #include <QObject>
 #include <QTimer>
 #include <QElapsedTimer>
+#include <QDate>
 #include "GameField.h"
 #include "Block.h"
 #include "BlockFactory.h"
 #include "GameStats.h"
+#include "LineClearEvent.h"
+#include "PerfStats.h"
+#include "GameClock.h"
+#include "InputHandler.h"
 
 class GameEngine : public QObject
 {
@@ -32,6 +37,13 @@ public:
     void restartGame();
     void endGame();
 
+    // 种子设置（下一局生效，用于复现对局）
+    void setSeed(quint64 seed);
+    void clearSeed();
+    static quint64 dailySeed(const QDate& date);  // 每日挑战种子，同一天所有玩家相同
+    BlockFactory::RandomizerState getRandomizerState() const { return m_blockFactory->getRandomizerState(); }
+    bool setRandomizerState(const BlockFactory::RandomizerState& state) { return m_blockFactory->setRandomizerState(state); }
+
     // 方块操作
     bool moveLeft();
     bool moveRight();
@@ -42,18 +54,25 @@ public:
     void hardDrop();
     void holdBlock();
 
+    // 输入队列：输入按时间戳（GameClock 纳秒）排队，模拟步进时先推进到各输入的时间戳再按时间顺序应用；
+    // 输入到达时立即步进到当前时间，不等下一次计时器
+    void queueInput(InputHandler::GameAction action, bool pressed, qint64 timestamp);
+
     // 游戏状态查询
     GameState getGameState() const { return m_gameState; }
     const GameStats& getGameStats() const { return m_gameStats; }
     const GameField& getGameField() const { return m_gameField; }
     const Block& getCurrentBlock() const { return m_currentBlock; }
-    const Block& getNextBlock() const { return m_nextBlock; }
+    Block getNextBlock() const { return m_blockFactory->peekBlock(0); }
+    QVector<Block> getPreviewBlocks(int count) const; // 预览队列（不含下一个方块）
     const Block& getHoldBlock() const { return m_holdBlock; }
     bool canHold() const { return m_canHold; }
 
     // 动态下落相关
     float getFallProgress() const { return m_fallProgress; }
+    float getInterpolatedFall() const;  // 绘制用的格内下落进度 [0, 1)，不能下落时为 0
     bool isFastDropping() const { return m_fastDrop; }
+    bool isLineClearPending() const { return m_lineClearDelayLeft > 0; }  // 消行等待中（尚未生成新方块）
 
     // 幽灵方块相关
     Block getGhostBlock() const;
@@ -65,6 +84,8 @@ signals:
     void currentBlockChanged();
     void nextBlockChanged();
     void holdBlockChanged();
+    void blockLocked(const Block& block);            // 方块锁定（已放置到场地，尚未消行）
+    void linesRemoved(const LineClearEvent& event);  // 消行（场地已更新，事件中为消除前的行内容）
 
     // 更新等级信号
     void updateNewLevel(int level);
@@ -73,12 +94,32 @@ private slots:
     void updateGame();
 
 private:
+    // 输入队列：排队的输入
+    struct QueuedInput {
+        InputHandler::GameAction action;
+        bool pressed;           // 按下或释放
+        qint64 timestamp;       // GameClock 纳秒
+    };
+
+    void advanceTo(qint64 time);            // 按时间顺序应用不晚于 time 的输入，并把模拟推进到 time
+    void step(qint64 time);                 // 从上次步进推进到 time，横移自动重复与下落按时间先后交替
+    void advanceGravity(qint64 time);       // 从上次步进推进到 time（下落和消行等待）
+    void applyInput(const QueuedInput& input);
+
+    // 横移自动重复（DAS/ARR），时间均为 GameClock 纳秒
+    void pressShift(int direction);         // 按下横移键：立即移动一格并开始充能
+    void releaseShift(int direction);       // 松开横移键：另一方向仍按住时改为向该方向充能
+    void resetHeldKeys();                   // 清除按键状态（开始、暂停、继续时按键可能已变化）
+    qint64 shiftDelay() const;              // DAS：按下到开始自动重复的时间（随等级缩短）
+
     // 游戏逻辑
     void extracted(bool &canSpawn, QVector<Position> &cells);
-    void spawnNewBlock();                   // 生成新方块
+    // 生成新方块；initialActions 为 true 时应用生成前按住的暂存和旋转（IHS/IRS），暂存换出的方块不再应用
+    void spawnNewBlock(bool initialActions = false);
     void placeCurrentBlock();               // 放置方块
     void lockCurrentBlock();                // 锁定方块
     int clearCompletedLines();              // 消除所有完整行
+    void recordLineClear(const QVector<int>& lines);  // 在消除前把整行内容复制到消行事件
     void updateGameStats(int linesCleared); // 更新游戏数据
     void calculateScore(int linesCleared);  // 计算得分
     void updateLevel();                     // 更新游戏等级
@@ -94,20 +135,44 @@ private:
     GameState m_gameState;
     GameField m_gameField;
     Block m_currentBlock;
-    Block m_nextBlock;
     Block m_holdBlock;
     bool m_canHold;
     GameStats m_gameStats;
 
     // 计时器
     QTimer *m_gameTimer;
+    QElapsedTimer m_tickClock;  // 性能采样用时钟
+    qint64 m_lastTickNs;        // 上次更新的时间（纳秒），-1 表示计时器刚启动
 
     // 动态下落相关
     float m_fallProgress;    // 下落进度 0.0 - 1.0
     bool m_fastDrop;         // 是否快速下落
     int m_fallSpeed;         // 下落速度 (ms/cell)
     int m_fastFallSpeed;     // 快速下落速度 (ms/cell)
-    qint64 m_lastUpdateTime; // 上次更新时间
+    qint64 m_lastUpdateTime; // 上次模拟步进的时间（GameClock 纳秒）
+
+    // 消行相关
+    LineClearEvent m_lineClearEvent; // 复用的消行事件，消行时不分配内存
+    qint64 m_lineClearDelayLeft;     // 距生成新方块的剩余等待时间（纳秒），0 为不在等待
+
+    // 输入队列
+    QVector<QueuedInput> m_inputQueue;
+
+    // 横移自动重复
+    bool m_leftHeld;
+    bool m_rightHeld;
+    int m_shiftDirection;           // 正在自动重复的方向：-1 左，1 右，0 无
+    qint64 m_shiftNextRepeat;       // 下一次自动重复的时间
+    qint64 m_shiftInterval;         // ARR（纳秒），0 表示充能后直接移到墙边
+
+    // 生成新方块时仍按住的操作（锁定到生成之间的输入不丢失，新方块出现时立即应用）
+    bool m_softDropHeld;            // 软下落在新方块上继续生效
+    bool m_holdHeld;                // IHS：生成时直接暂存
+    int m_rotateHeld;               // IRS：生成时的旋转方向，1 顺时针，-1 逆时针，0 无
+
+    // 种子相关
+    bool m_hasFixedSeed;     // 是否使用指定种子
+    quint64 m_fixedSeed;     // 指定的种子
 
     // 系统组件
     QScopedPointer<BlockFactory> m_blockFactory;
@@ -1,10 +1,19 @@
 #include "GameField.h"
 #include <algorithm>
+#include <atomic>
 #include <qdebug.h>
 
+// 代数在所有场地间全局递增，场地被整体替换后也不会与旧代数重复
+static std::atomic<quint64> s_nextGeneration(1);
+
 GameField::GameField(int width, int height)
-    : m_width(width), m_height(height)
+    : m_width(width), m_height(height), m_generation(0)
 {
+    if (m_width > MAX_WIDTH) {
+        qWarning() << "Field width" << m_width << "exceeds maximum, clamped to" << MAX_WIDTH;
+        m_width = MAX_WIDTH;
+    }
+    m_fullRowMask = (m_width == 64) ? ~0ULL : ((1ULL << m_width) - 1);
     initializeGrid();
 }
 
@@ -17,6 +26,38 @@ void GameField::initializeGrid()
             m_grid[y][x] = Cell();
         }
     }
+    m_rowMasks.fill(0, m_height);
+
+    m_generation = s_nextGeneration.fetch_add(1, std::memory_order_relaxed);
+    m_rowGenerations.fill(m_generation, m_height);
+}
+
+void GameField::touchRow(int y)
+{
+    m_generation = s_nextGeneration.fetch_add(1, std::memory_order_relaxed);
+    m_rowGenerations[y] = m_generation;
+}
+
+bool GameField::canPlace(const PieceSet::Rotation& rotation, int x, int y) const
+{
+    const int left = x + rotation.bounds.left();
+    const int top = y + rotation.bounds.top();
+
+    // 检查左右边界和底部边界
+    if (left < 0 || left + rotation.bounds.width() > m_width ||
+        top + rotation.bounds.height() > m_height) {
+        return false;
+    }
+
+    // 逐行比较位图（场地上方的部分不检查）
+    for (int row = 0; row < rotation.bounds.height(); ++row) {
+        const int fieldY = top + row;
+        if (fieldY >= 0 && (m_rowMasks[fieldY] & (rotation.rowMasks[row] << left))) {
+            return false;
+        }
+    }
+
+    return true;
 }
 
 bool GameField::isCellEmpty(int x, int y) const
@@ -35,11 +76,22 @@ QColor GameField::getCellColor(int x, int y) const
     return m_grid[y][x].color;
 }
 
-void GameField::setCell(int x, int y, const QColor& color)
+int GameField::getCellType(int x, int y) const
+{
+    if (x < 0 || x >= m_width || y < 0 || y >= m_height) {
+        return -1;
+    }
+    return m_grid[y][x].type;
+}
+
+void GameField::setCell(int x, int y, const QColor& color, int type)
 {
     if (x >= 0 && x < m_width && y >= 0 && y < m_height) {
         m_grid[y][x].occupied = true;
         m_grid[y][x].color = color;
+        m_grid[y][x].type = type;
+        m_rowMasks[y] |= (1ULL << x);
+        touchRow(y);
     }
 }
 
@@ -48,6 +100,9 @@ void GameField::clearCell(int x, int y)
     if (x >= 0 && x < m_width && y >= 0 && y < m_height) {
         m_grid[y][x].occupied = false;
         m_grid[y][x].color = Qt::black;
+        m_grid[y][x].type = -1;
+        m_rowMasks[y] &= ~(1ULL << x);
+        touchRow(y);
     }
 }
 
@@ -64,12 +119,7 @@ bool GameField::isLineComplete(int y) const
 {
     if (y < 0 || y >= m_height) return false;
 
-    for (int x = 0; x < m_width; ++x) {
-        if (!m_grid[y][x].occupied) {
-            return false;
-        }
-    }
-    return true;
+    return m_rowMasks[y] == m_fullRowMask;
 }
 
 QVector<int> GameField::findCompleteLines() const
@@ -95,12 +145,16 @@ void GameField::removeLine(int y)
         for (int x = 0; x < m_width; ++x) {
             m_grid[row][x] = m_grid[row - 1][x];
         }
+        m_rowMasks[row] = m_rowMasks[row - 1];
+        touchRow(row);
     }
 
     // 清空最顶行
     for (int x = 0; x < m_width; ++x) {
         m_grid[0][x] = Cell();
     }
+    m_rowMasks[0] = 0;
+    touchRow(0);
 }
 
 void GameField::removeLines(const QVector<int>& lines)
@@ -139,6 +193,8 @@ void GameField::shiftLinesDown(int startY, int count)
         for (int x = 0; x < m_width; ++x) {
             m_grid[row][x] = m_grid[row - count][x];
         }
+        m_rowMasks[row] = m_rowMasks[row - count];
+        touchRow(row);
     }
 
     // 清空顶部的count行
@@ -4,6 +4,7 @@
 #include <QColor>
 #include <QRect>
 #include "GameConfig.h"
+#include "PieceSet.h"
 
 class GameField
 {
@@ -11,16 +12,20 @@ public:
     struct Cell {
         bool occupied;
         QColor color;
+        int type;       // 方块种类（主题按种类选择贴图），-1 表示未知
 
-        Cell() : occupied(false), color(Qt::black) {}
+        Cell() : occupied(false), color(Qt::black), type(-1) {}
     };
 
+    static constexpr int MAX_WIDTH = 64;  // 最大宽度（每行占用情况用一个64位位图表示）
+
     explicit GameField(int width = FIELD_WIDTH, int height = FIELD_HEIGHT);
 
     // 基本操作
     bool isCellEmpty(int x, int y) const;
     QColor getCellColor(int x, int y) const;
-    void setCell(int x, int y, const QColor& color);
+    int getCellType(int x, int y) const;
+    void setCell(int x, int y, const QColor& color, int type = -1);
     void clearCell(int x, int y);
     void clearField();
 
@@ -28,6 +33,14 @@ public:
     int getWidth() const { return m_width; }
     int getHeight() const { return m_height; }
     QRect getBounds() const { return QRect(0, 0, m_width, m_height); }
+    quint64 getRowMask(int y) const { return m_rowMasks[y]; }
+
+    // 变更代数：每次修改都会分配一个全局递增的新代数，界面据此只重绘变化的行
+    quint64 getGeneration() const { return m_generation; }
+    quint64 getRowGeneration(int y) const { return m_rowGenerations[y]; }
+
+    // 碰撞检测：方块的某个旋转状态放在 (x, y) 处是否合法（按行位图比较）
+    bool canPlace(const PieceSet::Rotation& rotation, int x, int y) const;
 
     // 行操作
     bool isLineComplete(int y) const;
@@ -43,8 +56,13 @@ private:
     int m_width;
     int m_height;
     QVector<QVector<Cell>> m_grid;
+    QVector<quint64> m_rowMasks;  // 每行的占用位图，与 m_grid 同步维护
+    quint64 m_fullRowMask;        // 整行占满时的位图
+    QVector<quint64> m_rowGenerations;  // 每行最后一次修改时的代数
+    quint64 m_generation;               // 整个场地最后一次修改时的代数
 
     void initializeGrid();
+    void touchRow(int y);         // 标记某行已修改
     void shiftLinesDown(int startY, int count);
 };
 
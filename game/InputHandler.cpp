@@ -1,118 +1,147 @@
+#include <QFile>
+#include <QKeySequence>
+#include <QStringList>
+#include <QDebug>
+#include <algorithm>
 #include "InputHandler.h"
 #include "GameConfig.h"
 
+namespace {
+
+// 各操作在配置文件中的名称和内置按键
+struct ActionBinding {
+    InputHandler::GameAction action;
+    const char* name;
+    const char* defaultKeys;
+};
+
+const ActionBinding ACTION_BINDINGS[] = {
+    { InputHandler::ACTION_MOVE_LEFT,  "moveLeft",  "Left, A" },
+    { InputHandler::ACTION_MOVE_RIGHT, "moveRight", "Right, D" },
+    { InputHandler::ACTION_SOFT_DROP,  "softDrop",  "Down, S" },
+    { InputHandler::ACTION_HARD_DROP,  "hardDrop",  "Space" },
+    { InputHandler::ACTION_ROTATE_CW,  "rotateCW",  "Up, W" },
+    { InputHandler::ACTION_ROTATE_CCW, "rotateCCW", "Z" },
+    { InputHandler::ACTION_HOLD,       "hold",      "C" },
+    { InputHandler::ACTION_PAUSE,      "pause",     "P" },
+    { InputHandler::ACTION_RESTART,    "restart",   "R" },
+};
+
+} // namespace
+
 InputHandler::InputHandler(QObject* parent)
     : QObject(parent)
-    , m_currentRepeatingAction(ACTION_COUNT)
-    , m_isRepeating(false)
-    , add_autoRepeatDelay(ADD_REPEAT_DELAY)
+    , m_configWatcher(new QFileSystemWatcher(this))
 {
-    m_autoRepeatTimer = new QTimer(this);
-    connect(m_autoRepeatTimer, &QTimer::timeout, this, &InputHandler::onAutoRepeat);
-    m_autoRepeatTimer->setInterval(AUTO_REPEAT_INTERVAL);
-    initializeDefaultMapping();
+    reloadBindings();
+
+    const QString path = QString::fromStdString(GAME_CONFIG.getConfigFilePath());
+    if (!path.isEmpty() && QFile::exists(path)) {
+        m_configWatcher->addPath(path);
+    }
+    connect(m_configWatcher, &QFileSystemWatcher::fileChanged, this, &InputHandler::onConfigFileChanged);
 }
 
-void InputHandler::initializeDefaultMapping()
+int InputHandler::keyIndex(int key)
 {
-    keyMapping.clear();
-
-    // 默认按键映射，wasd也可以控制上下左右
-    keyMapping[Qt::Key_Left] = ACTION_MOVE_LEFT;
-    keyMapping[Qt::Key_A] = ACTION_MOVE_LEFT;
-    keyMapping[Qt::Key_Right] = ACTION_MOVE_RIGHT;
-    keyMapping[Qt::Key_D] = ACTION_MOVE_RIGHT;
-    keyMapping[Qt::Key_Down] = ACTION_SOFT_DROP;
-    keyMapping[Qt::Key_S] = ACTION_SOFT_DROP;
-    keyMapping[Qt::Key_Space] = ACTION_HARD_DROP;
-    keyMapping[Qt::Key_Up] = ACTION_ROTATE_CW;
-    keyMapping[Qt::Key_W] = ACTION_ROTATE_CW;
-    keyMapping[Qt::Key_Z] = ACTION_ROTATE_CCW;
-    keyMapping[Qt::Key_C] = ACTION_HOLD;
-    keyMapping[Qt::Key_P] = ACTION_PAUSE;
-    keyMapping[Qt::Key_R] = ACTION_RESTART;
+    if (key >= 0 && key < 0x100) {
+        return key;
+    }
+    if (key >= Qt::Key_Escape && key < Qt::Key_Escape + 0x100) {
+        return 0x100 + (key - Qt::Key_Escape);
+    }
+    return -1;
 }
 
-bool InputHandler::processKeyEvent(QKeyEvent* event)
+int InputHandler::parseKey(const QString& name)
 {
-    Qt::Key key = static_cast<Qt::Key>(event->key());
-
-    if (!keyMapping.contains(key)) {
-        return false;
+    const QKeySequence sequence = QKeySequence::fromString(name.trimmed(), QKeySequence::PortableText);
+    if (sequence.isEmpty()) {
+        return 0;
     }
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    return sequence[0].key();
+#else
+    return sequence[0] & ~Qt::KeyboardModifierMask;
+#endif
+}
 
-    GameAction action = keyMapping[key];
+void InputHandler::reloadBindings()
+{
+    std::fill(m_keyTable, m_keyTable + KEY_TABLE_SIZE, static_cast<quint8>(ACTION_COUNT));
+    for (QVector<int>& keys : m_actionKeys) {
+        keys.clear();
+    }
 
-    if (event->type() == QEvent::KeyPress) {
-        // 处理按键按下
-        if (!m_isRepeating) {
-            emit actionTriggered(action);
+    const std::string section = "Keys." + KEY_PROFILE;
+    for (const ActionBinding& binding : ACTION_BINDINGS) {
+        const QString keys = QString::fromStdString(GAME_CONFIG.getStringValue(section, binding.name, binding.defaultKeys));
 
-            // 对于移动操作，启动自动重复
-            if (action == ACTION_MOVE_LEFT || action == ACTION_MOVE_RIGHT) {
-                startAutoRepeat(action);
+        for (const QString& name : keys.split(',', Qt::SkipEmptyParts)) {
+            const int key = parseKey(name);
+            const int index = keyIndex(key);
+            if (index <= 0) {
+                qWarning() << "Unknown key" << name.trimmed() << "for action" << binding.name;
+                continue;
             }
-            // 软下落不启动自动重复，而是持续状态
-            else if (action == ACTION_SOFT_DROP) {
-                m_currentRepeatingAction = action;
-                m_isRepeating = true;
+            if (m_keyTable[index] != ACTION_COUNT) {
+                if (m_keyTable[index] != binding.action) {
+                    qWarning() << "Key" << name.trimmed() << "is bound to several actions, using" << binding.name;
+                }
+                m_actionKeys[m_keyTable[index]].removeAll(key);
             }
+            m_keyTable[index] = static_cast<quint8>(binding.action);
+            m_actionKeys[binding.action].append(key);
         }
-        else if (action != ACTION_MOVE_LEFT && action != ACTION_MOVE_RIGHT) {
-            // 自动重复状态下依然可以响应其他按键
-            emit actionTriggered(action);
-        }
-        return true;
-    }
-    else if (event->type() == QEvent::KeyRelease) {
-        // 处理按键释放
-        if (m_isRepeating && action == m_currentRepeatingAction) {
-            // 停止自动重复
-            stopAutoRepeat();
-
-            // 如果是软下落释放，发送停止信号
-            if (action == ACTION_SOFT_DROP) {
-                emit actionReleased(action);
-            }
-        } else {
-            // 即使不在重复状态，也要发送释放信号（针对软下落）
-            if (action == ACTION_SOFT_DROP) {
-                emit actionReleased(action);
-            }
-        }
-        return true;
     }
 
-    return false;
+    emit bindingsChanged();
 }
 
-void InputHandler::startAutoRepeat(GameAction action)
+QString InputHandler::keyText(GameAction action) const
 {
-    m_currentRepeatingAction = action;
-    m_autoRepeatTimer->setSingleShot(true);
-    m_autoRepeatTimer->start(AUTO_REPEAT_DELAY + add_autoRepeatDelay);
-    m_isRepeating = true;
+    if (action < 0 || action >= ACTION_COUNT || m_actionKeys[action].isEmpty()) {
+        return "未绑定";
+    }
+
+    QStringList names;
+    for (int key : m_actionKeys[action]) {
+        names << QKeySequence(key).toString(QKeySequence::NativeText);
+    }
+    return names.join(" / ");
 }
 
-void InputHandler::stopAutoRepeat()
+void InputHandler::onConfigFileChanged(const QString& path)
 {
-    m_autoRepeatTimer->stop();
-    m_currentRepeatingAction = ACTION_COUNT;
-    m_isRepeating = false;
+    // 只更新按键绑定；下落速度、DAS/ARR 等设置不在对局中途改变
+    GAME_CONFIG.reloadKeyBindings();
+    reloadBindings();
+
+    // 部分编辑器保存时会替换文件，监视随之失效，需要重新添加
+    if (!m_configWatcher->files().contains(path) && QFile::exists(path)) {
+        m_configWatcher->addPath(path);
+    }
 }
 
-void InputHandler::onAutoRepeat()
+bool InputHandler::processKeyEvent(QKeyEvent* event, qint64 timestamp)
 {
-    if (m_isRepeating && m_currentRepeatingAction != ACTION_COUNT) {
-        emit actionTriggered(m_currentRepeatingAction);
-        m_autoRepeatTimer->setSingleShot(false);
-        m_autoRepeatTimer->start(AUTO_REPEAT_INTERVAL);
+    // 一次范围判断加一次数组访问
+    const int index = keyIndex(event->key());
+    if (index < 0 || m_keyTable[index] == ACTION_COUNT) {
+        return false;
     }
-}
 
-void InputHandler::updateAutoRepeatDelay(int level){
-    if (add_autoRepeatDelay <= 0)
-        return;
-    // 根据游戏等级缩短自动重复等待延迟
-    add_autoRepeatDelay = (ADD_REPEAT_DELAY - 20 * level) > 0 ? (ADD_REPEAT_DELAY - 20 * level) : 0;
+    const GameAction action = static_cast<GameAction>(m_keyTable[index]);
+
+    // 按住不放的效果（横移的自动重复、软下落）由引擎根据按下和释放的时间戳计算
+    if (event->type() == QEvent::KeyPress) {
+        emit actionTriggered(action, timestamp);
+        return true;
+    }
+    else if (event->type() == QEvent::KeyRelease) {
+        emit actionReleased(action, timestamp);
+        return true;
+    }
+
+    return false;
 }
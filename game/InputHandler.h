@@ -1,10 +1,18 @@
 #ifndef INPUTHANDLER_H
 #define INPUTHANDLER_H
 #include <QObject>
-#include <QHash>
-#include <QTimer>
 #include <QKeyEvent>
+#include <QFileSystemWatcher>
+#include <QVector>
 
+// 按键映射：把按键的按下和释放转换为带时间戳的游戏操作
+// 横移的自动重复（DAS/ARR）由引擎在模拟步进中按时间戳计算，这里只转发按下和释放
+//
+// 按键从配置文件的 [Keys.<方案名>] 段读取（方案名为 [Input] keyProfile），每个操作可绑定多个按键，例如
+//     [Keys.default]
+//     moveLeft = Left, A
+//     hardDrop = Space
+// 段中没有的操作使用内置按键。绑定编译为按键值直接索引的查找表，配置文件变化后只重新加载按键绑定
 class InputHandler : public QObject
 {
     Q_OBJECT
@@ -23,34 +31,37 @@ public:
         ACTION_COUNT
     };
 
+    // 查找表范围：0x000-0x0ff 为 Latin-1 按键，0x100-0x1ff 为从 Qt::Key_Escape 开始的功能键
+    static constexpr int KEY_TABLE_SIZE = 0x200;
+
     explicit InputHandler(QObject* parent = nullptr);
 
-    // 输入处理
-    bool processKeyEvent(QKeyEvent* event);
+    // 输入处理，timestamp 为收到按键事件的时间（GameClock 纳秒）
+    bool processKeyEvent(QKeyEvent* event, qint64 timestamp);
+
+    // 按当前配置重新生成查找表
+    void reloadBindings();
+
+    // 操作绑定的按键名称（按系统习惯显示，多个按键用 "/" 分隔），用于界面上的按键说明
+    QString keyText(GameAction action) const;
 
 signals:
-    void actionTriggered(InputHandler::GameAction action);
-    void actionReleased(InputHandler::GameAction action);
+    void bindingsChanged();     // 按键绑定已重新加载，界面需要更新按键说明
 
-public slots:
-    void updateAutoRepeatDelay(int level);
+    // timestamp 为操作发生的时间（GameClock 纳秒），引擎按时间戳顺序应用
+    void actionTriggered(InputHandler::GameAction action, qint64 timestamp);
+    void actionReleased(InputHandler::GameAction action, qint64 timestamp);
 
 private slots:
-    void onAutoRepeat();
+    void onConfigFileChanged(const QString& path);  // 重新读取配置文件并更新绑定
 
 private:
-    void initializeDefaultMapping();
-    void startAutoRepeat(GameAction action);
-    void stopAutoRepeat();
-
-    // 输入配置
-    QHash<Qt::Key, GameAction> keyMapping; // 按键映射
-    int add_autoRepeatDelay;
-
-    // 自动重复状态
-    QTimer* m_autoRepeatTimer;
-    GameAction m_currentRepeatingAction;
-    bool m_isRepeating;
+    static int keyIndex(int key);                   // 按键在查找表中的下标，不在表的范围内时返回 -1
+    static int parseKey(const QString& name);       // 按键名（如 "Left"、"A"、"Space"）转换为按键值，无法识别时返回 0
+
+    quint8 m_keyTable[KEY_TABLE_SIZE];              // 按键对应的操作，ACTION_COUNT 表示未绑定
+    QVector<int> m_actionKeys[ACTION_COUNT];        // 各操作实际生效的按键（只用于显示）
+    QFileSystemWatcher* m_configWatcher;            // 监视配置文件，修改后无需重启即可生效
 };
 
 #endif // INPUTHANDLER_H
@@ -0,0 +1,21 @@
+#ifndef LINECLEAREVENT_H
+#define LINECLEAREVENT_H
+#include <QColor>
+#include "GameField.h"
+#include "PieceSet.h"
+
+// 消行事件：被消除的行号和这些行消除前的格子颜色
+// 定长数组，引擎和界面按值复制时不分配内存
+struct LineClearEvent {
+    static constexpr int MAX_ROWS = PieceSet::MAX_SIZE;  // 一次最多消除的行数（不超过方块图案的边长）
+
+    int rowCount;                               // 消除的行数
+    int width;                                  // 场地宽度
+    int rows[MAX_ROWS];                         // 消除前的行号（从上到下）
+    QRgb cells[MAX_ROWS][GameField::MAX_WIDTH]; // 各行格子颜色，空格为 0
+    qint8 types[MAX_ROWS][GameField::MAX_WIDTH]; // 各行格子的方块种类，-1 为未知
+
+    LineClearEvent() : rowCount(0), width(0) {}
+};
+
+#endif // LINECLEAREVENT_H
@@ -0,0 +1,52 @@
+#include <algorithm>
+#include "PerfStats.h"
+
+static_assert((PerfStats::RING_SIZE & (PerfStats::RING_SIZE - 1)) == 0, "RING_SIZE must be a power of two");
+
+PerfStats& PerfStats::getInstance()
+{
+    static PerfStats instance;
+    return instance;
+}
+
+PerfStats::PerfStats()
+{
+    for (Ring& ring : m_rings) {
+        ring.head.store(0, std::memory_order_relaxed);
+        for (std::atomic<qint64>& sample : ring.samples) {
+            sample.store(0, std::memory_order_relaxed);
+        }
+    }
+    for (std::atomic<quint64>& counter : m_counters) {
+        counter.store(0, std::memory_order_relaxed);
+    }
+}
+
+PerfStats::Summary PerfStats::summarize(Channel channel) const
+{
+    const Ring& ring = m_rings[channel];
+    const quint32 head = ring.head.load(std::memory_order_acquire);
+    const int count = static_cast<int>(qMin<quint32>(head, RING_SIZE));
+
+    Summary summary;
+    if (count == 0) return summary;
+
+    // 复制到栈上再排序，不影响写入线程
+    qint64 samples[RING_SIZE];
+    for (int i = 0; i < count; ++i) {
+        samples[i] = ring.samples[(head - count + i) & (RING_SIZE - 1)].load(std::memory_order_relaxed);
+    }
+
+    summary.count = count;
+    summary.max = *std::max_element(samples, samples + count);
+
+    qint64* p50 = samples + count / 2;
+    std::nth_element(samples, p50, samples + count);
+    summary.p50 = *p50;
+
+    qint64* p99 = samples + qMin(count - 1, count * 99 / 100);
+    std::nth_element(samples, p99, samples + count);
+    summary.p99 = *p99;
+
+    return summary;
+}
@@ -0,0 +1,73 @@
+#ifndef PERFSTATS_H
+#define PERFSTATS_H
+#include <QtGlobal>
+#include <atomic>
+
+// 性能采样
+// 每个采样通道是一个定长环形缓冲（纳秒），同一通道只由一个线程写入，写入只是两次原子存储，不加锁，可在发布版本中常开；
+// 任意线程可随时读取最近的采样计算分位数（读取期间被覆盖的个别采样不影响统计结果）
+class PerfStats
+{
+public:
+    // 采样通道
+    enum Channel {
+        CHANNEL_PAINT,          // 场地控件 paintEvent 耗时（界面线程）
+        CHANNEL_RENDER,         // 渲染线程合成一帧的耗时
+        CHANNEL_TICK,           // GameEngine::updateGame 耗时（界面线程）
+        CHANNEL_TICK_JITTER,    // 游戏计时器实际间隔与设定间隔之差的绝对值
+        CHANNEL_COUNT
+    };
+
+    // 计数器
+    enum Counter {
+        COUNTER_REPAINT,        // 场地控件重绘次数
+        COUNTER_SIGNAL,         // 场地控件收到的引擎信号数
+        COUNTER_COUNT
+    };
+
+    static constexpr int RING_SIZE = 256;  // 每个通道保留的采样数（2 的幂）
+
+    // 最近采样的统计（纳秒）
+    struct Summary {
+        int count;
+        qint64 p50;
+        qint64 p99;
+        qint64 max;
+
+        Summary() : count(0), p50(0), p99(0), max(0) {}
+    };
+
+    static PerfStats& getInstance();
+
+    // 记录一次采样（只能由该通道的写入线程调用）
+    void record(Channel channel, qint64 ns)
+    {
+        Ring& ring = m_rings[channel];
+        const quint32 head = ring.head.load(std::memory_order_relaxed);
+        ring.samples[head & (RING_SIZE - 1)].store(ns, std::memory_order_relaxed);
+        ring.head.store(head + 1, std::memory_order_release);
+    }
+
+    void increment(Counter counter) { m_counters[counter].fetch_add(1, std::memory_order_relaxed); }
+    quint64 getCount(Counter counter) const { return m_counters[counter].load(std::memory_order_relaxed); }
+
+    // 计算通道中最近采样的分位数
+    Summary summarize(Channel channel) const;
+
+private:
+    PerfStats();
+    PerfStats(const PerfStats&) = delete;
+    PerfStats& operator=(const PerfStats&) = delete;
+
+    struct Ring {
+        std::atomic<quint32> head;             // 已写入的采样总数
+        std::atomic<qint64> samples[RING_SIZE];
+    };
+
+    Ring m_rings[CHANNEL_COUNT];
+    std::atomic<quint64> m_counters[COUNTER_COUNT];
+};
+
+#define PERF_STATS              PerfStats::getInstance()
+
+#endif // PERFSTATS_H
@@ -0,0 +1,194 @@
+#include "PieceSet.h"
+#include <QFile>
+#include <QHash>
+#include <QStringList>
+#include <QDebug>
+#include "SimpleIni.h"
+
+// 内置标准方块定义，与外部数据文件格式相同
+// shape 中每行用 '/' 分隔，'X' 表示占用，'.' 表示空
+static const char STANDARD_PIECE_SET[] =
+    "[PieceSet]\n"
+    "name = standard\n"
+    "pieces = I,O,T,S,Z,J,L\n"
+    "\n"
+    "[I]\n"
+    "shape = ..../XXXX/..../....\n"
+    "color = #00FFFF\n"
+    "\n"
+    "[O]\n"
+    "shape = XX/XX\n"
+    "color = #FFFF00\n"
+    "\n"
+    "[T]\n"
+    "shape = .X./XXX/...\n"
+    "color = #800080\n"
+    "\n"
+    "[S]\n"
+    "shape = .XX/XX./...\n"
+    "color = #00FF00\n"
+    "\n"
+    "[Z]\n"
+    "shape = XX./.XX/...\n"
+    "color = #FF0000\n"
+    "\n"
+    "[J]\n"
+    "shape = X../XXX/...\n"
+    "color = #0000FF\n"
+    "\n"
+    "[L]\n"
+    "shape = ..X/XXX/...\n"
+    "color = #FFA500\n";
+
+const PieceSet* PieceSet::standard()
+{
+    return get("standard");
+}
+
+const PieceSet* PieceSet::get(const QString& nameOrPath)
+{
+    // 已加载的集合常驻内存，方块只保存指向其中数据的指针
+    static QHash<QString, PieceSet*> s_cache;
+
+    auto it = s_cache.constFind(nameOrPath);
+    if (it != s_cache.constEnd()) {
+        return it.value();
+    }
+
+    QByteArray data;
+    if (nameOrPath == "standard") {
+        data = QByteArray(STANDARD_PIECE_SET);
+    } else {
+        QFile file(nameOrPath);
+        if (!file.open(QIODevice::ReadOnly)) {
+            qWarning() << "Cannot open piece set:" << nameOrPath;
+            return nullptr;
+        }
+        data = file.readAll();
+    }
+
+    PieceSet* pieceSet = new PieceSet();
+    if (!pieceSet->loadFromData(data)) {
+        qWarning() << "Invalid piece set:" << nameOrPath;
+        delete pieceSet;
+        return nullptr;
+    }
+
+    s_cache.insert(nameOrPath, pieceSet);
+    return pieceSet;
+}
+
+bool PieceSet::loadFromData(const QByteArray& data)
+{
+    CSimpleIniA ini;
+    ini.SetUnicode();
+    if (ini.LoadData(data.constData(), data.size()) < 0) {
+        return false;
+    }
+
+    m_name = QString::fromUtf8(ini.GetValue("PieceSet", "name", "unnamed"));
+    QStringList names = QString::fromUtf8(ini.GetValue("PieceSet", "pieces", "")).split(',', Qt::SkipEmptyParts);
+
+    m_pieces.clear();
+    for (QString name : std::as_const(names)) {
+        name = name.trimmed();
+        QByteArray section = name.toUtf8();
+
+        if (m_pieces.size() >= MAX_PIECES) {
+            qWarning() << "Too many pieces in set" << m_name << ", ignoring" << name;
+            break;
+        }
+
+        QString shape = QString::fromUtf8(ini.GetValue(section.constData(), "shape", ""));
+        QVector<QString> rows;
+        for (const QString& row : shape.split('/')) {
+            rows.append(row.trimmed());
+        }
+
+        Piece piece;
+        piece.name = name;
+        piece.color = QColor(QString::fromUtf8(ini.GetValue(section.constData(), "color", "#808080")));
+        piece.spawnOffsetY = static_cast<int>(ini.GetLongValue(section.constData(), "spawnOffsetY", 0));
+
+        if (!buildRotations(rows, piece)) {
+            qWarning() << "Invalid shape for piece" << name << ":" << shape;
+            return false;
+        }
+
+        m_pieces.append(piece);
+    }
+
+    return !m_pieces.isEmpty();
+}
+
+bool PieceSet::buildRotations(const QVector<QString>& rows, Piece& piece)
+{
+    // 图案补齐为正方形矩阵，旋转在矩阵内进行
+    int size = rows.size();
+    for (const QString& row : rows) {
+        size = qMax(size, static_cast<int>(row.size()));
+    }
+    if (size <= 0 || size > MAX_SIZE) {
+        return false;
+    }
+
+    bool pattern[MAX_SIZE][MAX_SIZE] = {};
+    for (int y = 0; y < rows.size(); ++y) {
+        for (int x = 0; x < rows[y].size(); ++x) {
+            QChar c = rows[y][x];
+            pattern[y][x] = (c == QLatin1Char('X') || c == QLatin1Char('x') || c == QLatin1Char('#'));
+        }
+    }
+
+    piece.size = size;
+
+    for (int r = 0; r < ROTATION_COUNT; ++r) {
+        Rotation& rotation = piece.rotations[r];
+        rotation.cellCount = 0;
+
+        int minX = size, maxX = -1, minY = size, maxY = -1;
+        for (int y = 0; y < size; ++y) {
+            for (int x = 0; x < size; ++x) {
+                if (!pattern[y][x]) continue;
+
+                if (rotation.cellCount >= MAX_CELLS) {
+                    return false;
+                }
+                rotation.cells[rotation.cellCount++] = Position(x, y);
+                minX = qMin(minX, x);
+                maxX = qMax(maxX, x);
+                minY = qMin(minY, y);
+                maxY = qMax(maxY, y);
+            }
+        }
+
+        if (rotation.cellCount == 0) {
+            return false;
+        }
+
+        rotation.bounds = QRect(minX, minY, maxX - minX + 1, maxY - minY + 1);
+        for (int i = 0; i < rotation.cellCount; ++i) {
+            const Position& cell = rotation.cells[i];
+            rotation.rowMasks[cell.y - minY] |= (1ULL << (cell.x - minX));
+        }
+
+        // 顺时针旋转90度，得到下一个旋转状态
+        bool rotated[MAX_SIZE][MAX_SIZE] = {};
+        for (int y = 0; y < size; ++y) {
+            for (int x = 0; x < size; ++x) {
+                rotated[x][size - 1 - y] = pattern[y][x];
+            }
+        }
+        for (int y = 0; y < size; ++y) {
+            for (int x = 0; x < size; ++x) {
+                pattern[y][x] = rotated[y][x];
+            }
+        }
+    }
+
+    // 生成时按初始状态的包围盒水平居中（与原先标准方块的生成位置一致）
+    const QRect& spawnBounds = piece.rotations[0].bounds;
+    piece.spawnOffsetX = -spawnBounds.left() - (spawnBounds.width() + 1) / 2;
+
+    return true;
+}
@@ -0,0 +1,67 @@
+#ifndef PIECESET_H
+#define PIECESET_H
+#include <QVector>
+#include <QColor>
+#include <QRect>
+#include <QString>
+#include <QByteArray>
+#include "Position.h"
+
+// 方块集合定义
+// 从数据文件加载任意多格骨牌（四格、五格或混合），加载时预计算所有旋转状态的
+// 格子坐标、按行位图和包围盒，碰撞检测和绘制都直接查表，不再逐次旋转矩阵
+class PieceSet
+{
+public:
+    static constexpr int MAX_CELLS = 8;       // 单个方块最多格子数
+    static constexpr int MAX_SIZE = 8;        // 图案矩阵最大边长
+    static constexpr int MAX_PIECES = 32;     // 单个集合最多方块种类
+    static constexpr int ROTATION_COUNT = 4;  // 旋转状态数
+
+    // 单个旋转状态的预计算数据（坐标相对于方块原点）
+    struct Rotation {
+        int cellCount;
+        Position cells[MAX_CELLS];  // 占用的格子
+        quint64 rowMasks[MAX_SIZE]; // 包围盒内每行的占用位图，最低位对应包围盒左列
+        QRect bounds;               // 包围盒
+
+        Rotation() : cellCount(0), rowMasks() {}
+    };
+
+    // 单种方块
+    struct Piece {
+        QString name;                        // 方块名
+        QColor color;                        // 方块颜色
+        int size;                            // 图案矩阵边长
+        int spawnOffsetX;                    // 生成时相对场地中线的横向偏移
+        int spawnOffsetY;                    // 生成时纵向坐标
+        Rotation rotations[ROTATION_COUNT];  // 各旋转状态
+
+        Piece() : size(0), spawnOffsetX(0), spawnOffsetY(0) {}
+    };
+
+    // 内置标准七种方块
+    static const PieceSet* standard();
+
+    // 按名称或路径获取方块集合（"standard" 为内置集合），加载失败时返回 nullptr
+    // 已加载的集合会被缓存，在程序生命周期内保持有效
+    static const PieceSet* get(const QString& nameOrPath);
+
+    // 属性获取
+    QString getName() const { return m_name; }
+    int getPieceCount() const { return m_pieces.size(); }
+    const Piece& getPiece(int index) const { return m_pieces[index]; }
+
+private:
+    PieceSet() = default;
+
+    // 从 ini 格式数据解析
+    bool loadFromData(const QByteArray& data);
+    // 根据图案生成所有旋转状态
+    static bool buildRotations(const QVector<QString>& rows, Piece& piece);
+
+    QString m_name;
+    QVector<Piece> m_pieces;
+};
+
+#endif // PIECESET_H
@@ -0,0 +1,50 @@
+#include "RandomGenerator.h"
+
+void RandomGenerator::setSeed(quint64 seed)
+{
+    // splitmix64：保证相近的种子也能得到差异很大的初始状态
+    for (quint64& word : m_state.s) {
+        seed += 0x9E3779B97F4A7C15ULL;
+        quint64 z = seed;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        word = z ^ (z >> 31);
+    }
+}
+
+void RandomGenerator::jump()
+{
+    static const quint64 JUMP[] = {
+        0x180EC6D33CFD0ABAULL, 0xD5A61266F0C9392CULL,
+        0xA9582618E03FC9AAULL, 0x39ABDC4529B1661CULL
+    };
+
+    State next = { { 0, 0, 0, 0 } };
+    for (quint64 jumpWord : JUMP) {
+        for (int b = 0; b < 64; ++b) {
+            if (jumpWord & (1ULL << b)) {
+                for (int i = 0; i < 4; ++i) {
+                    next.s[i] ^= m_state.s[i];
+                }
+            }
+            operator()();
+        }
+    }
+    m_state = next;
+}
+
+QDataStream& operator<<(QDataStream& out, const RandomGenerator::State& state)
+{
+    for (quint64 word : state.s) {
+        out << word;
+    }
+    return out;
+}
+
+QDataStream& operator>>(QDataStream& in, RandomGenerator::State& state)
+{
+    for (quint64& word : state.s) {
+        in >> word;
+    }
+    return in;
+}
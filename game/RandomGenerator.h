@@ -0,0 +1,74 @@
+#ifndef RANDOMGENERATOR_H
+#define RANDOMGENERATOR_H
+#include <QtGlobal>
+#include <QDataStream>
+
+// xoshiro256** 随机数生成器
+// 状态只有32字节，可直接拷贝/序列化，满足 UniformRandomBitGenerator 要求
+class RandomGenerator
+{
+public:
+    using result_type = quint64;
+
+    // 生成器内部状态
+    struct State {
+        quint64 s[4];
+    };
+
+    explicit RandomGenerator(quint64 seed = 0) { setSeed(seed); }
+
+    // 使用 splitmix64 将64位种子扩展为完整状态
+    void setSeed(quint64 seed);
+
+    // 生成下一个随机数
+    result_type operator()()
+    {
+        const quint64 result = rotl(m_state.s[1] * 5, 7) * 9;
+        const quint64 t = m_state.s[1] << 17;
+
+        m_state.s[2] ^= m_state.s[0];
+        m_state.s[3] ^= m_state.s[1];
+        m_state.s[1] ^= m_state.s[2];
+        m_state.s[0] ^= m_state.s[3];
+        m_state.s[2] ^= t;
+        m_state.s[3] = rotl(m_state.s[3], 45);
+
+        return result;
+    }
+
+    // 生成 [0, range) 区间内的均匀整数（与标准库实现无关，保证跨平台可复现）
+    quint32 bounded(quint32 range)
+    {
+        quint64 m = static_cast<quint64>(static_cast<quint32>(operator()() >> 32)) * range;
+        quint32 low = static_cast<quint32>(m);
+        if (low < range) {
+            const quint32 threshold = static_cast<quint32>(-range) % range;
+            while (low < threshold) {
+                m = static_cast<quint64>(static_cast<quint32>(operator()() >> 32)) * range;
+                low = static_cast<quint32>(m);
+            }
+        }
+        return static_cast<quint32>(m >> 32);
+    }
+
+    // 跳过 2^128 个数，用于生成互不重叠的独立随机流
+    void jump();
+
+    // 状态读写
+    const State& getState() const { return m_state; }
+    void setState(const State& state) { m_state = state; }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return ~static_cast<result_type>(0); }
+
+private:
+    static quint64 rotl(quint64 x, int k) { return (x << k) | (x >> (64 - k)); }
+
+    State m_state;
+};
+
+// 序列化支持
+QDataStream& operator<<(QDataStream& out, const RandomGenerator::State& state);
+QDataStream& operator>>(QDataStream& in, RandomGenerator::State& state);
+
+#endif // RANDOMGENERATOR_H
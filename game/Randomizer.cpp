@@ -0,0 +1,79 @@
+#include "Randomizer.h"
+#include <utility>
+
+Randomizer::Randomizer(int typeCount, Mode mode)
+    : m_mode(mode)
+    , m_typeCount(1)
+    , m_bagPos(0)
+{
+    setTypeCount(typeCount);
+    refillBag();
+}
+
+Randomizer::Mode Randomizer::modeFromString(const std::string& name)
+{
+    return name == "7-bag" ? MODE_7BAG : MODE_RANDOM;
+}
+
+bool Randomizer::parseMode(const std::string& name, Mode& mode)
+{
+    if (name == "7-bag") {
+        mode = MODE_7BAG;
+    } else if (name == "random") {
+        mode = MODE_RANDOM;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* Randomizer::modeName(Mode mode)
+{
+    return mode == MODE_7BAG ? "7-bag" : "random";
+}
+
+void Randomizer::setTypeCount(int typeCount)
+{
+    if (typeCount < 1) typeCount = 1;
+    if (typeCount > MAX_TYPES) typeCount = MAX_TYPES;
+
+    m_typeCount = typeCount;
+    m_bagPos = m_typeCount; // 下次取出时重新装袋
+}
+
+void Randomizer::setSeed(quint64 seed)
+{
+    m_generator.setSeed(seed);
+    refillBag();
+}
+
+void Randomizer::jump()
+{
+    m_generator.jump();
+    refillBag();
+}
+
+void Randomizer::setRemaining(const int* types, int count)
+{
+    if (count > m_typeCount) count = m_typeCount;
+
+    // 剩余方块放在袋子末尾
+    m_bagPos = m_typeCount - count;
+    for (int i = 0; i < count; ++i) {
+        m_bag[m_bagPos + i] = types[i];
+    }
+}
+
+void Randomizer::refillBag()
+{
+    for (int i = 0; i < m_typeCount; ++i) {
+        m_bag[i] = i;
+    }
+
+    // 随机打乱袋子（Fisher-Yates，不依赖标准库实现，保证跨平台可复现）
+    for (int i = m_typeCount - 1; i > 0; --i) {
+        int j = static_cast<int>(m_generator.bounded(static_cast<quint32>(i + 1)));
+        std::swap(m_bag[i], m_bag[j]);
+    }
+    m_bagPos = 0;
+}
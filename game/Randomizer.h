@@ -0,0 +1,66 @@
+#ifndef RANDOMIZER_H
+#define RANDOMIZER_H
+#include <string>
+#include "RandomGenerator.h"
+
+// 方块随机化算法
+// 只处理方块类型下标，不依赖 Qt 容器，供 BlockFactory 和离线分析工具共用
+class Randomizer
+{
+public:
+    // 随机模式
+    enum Mode {
+        MODE_7BAG,    // 袋子模式：每轮所有类型各出现一次
+        MODE_RANDOM   // 完全随机
+    };
+
+    static constexpr int MAX_TYPES = 32;  // 支持的最大方块类型数
+
+    explicit Randomizer(int typeCount = 7, Mode mode = MODE_7BAG);
+
+    // 配置
+    static Mode modeFromString(const std::string& name);                 // 无法识别的名称按完全随机处理（兼容旧配置）
+    static bool parseMode(const std::string& name, Mode& mode);          // 只接受 "7-bag" 和 "random"
+    static const char* modeName(Mode mode);                               // parseMode 接受的名称
+    void setMode(Mode mode) { m_mode = mode; }
+    Mode getMode() const { return m_mode; }
+    void setTypeCount(int typeCount);
+    int getTypeCount() const { return m_typeCount; }
+
+    // 播种并重置袋子
+    void setSeed(quint64 seed);
+
+    // 切换到一条独立的随机流（用于多线程统计）
+    void jump();
+
+    // 生成下一个方块类型
+    int next()
+    {
+        if (m_mode == MODE_RANDOM) {
+            return static_cast<int>(m_generator.bounded(static_cast<quint32>(m_typeCount)));
+        }
+
+        if (m_bagPos >= m_typeCount) {
+            refillBag();
+        }
+        return m_bag[m_bagPos++];
+    }
+
+    // 状态读写（用于序列化）
+    const RandomGenerator& getGenerator() const { return m_generator; }
+    RandomGenerator& getGenerator() { return m_generator; }
+    int getRemainingCount() const { return m_typeCount - m_bagPos; }
+    int getRemaining(int index) const { return m_bag[m_bagPos + index]; }
+    void setRemaining(const int* types, int count);
+
+private:
+    void refillBag();
+
+    Mode m_mode;
+    int m_typeCount;
+    RandomGenerator m_generator;
+    int m_bag[MAX_TYPES];   // 当前袋子
+    int m_bagPos;           // 袋子中下一个取出的位置
+};
+
+#endif // RANDOMIZER_H
@@ -73,6 +73,50 @@ bool ScoreManager::createTable()
         return false;
     }
 
+    // 每日挑战成绩表，每条记录带种子、随机模式和方块集合，不做数量裁剪
+    QString createDailyTableSql =
+        "CREATE TABLE IF NOT EXISTS daily_scores ("
+        "id INTEGER PRIMARY KEY AUTOINCREMENT, "
+        "seed INTEGER NOT NULL, "
+        "mode TEXT NOT NULL DEFAULT '', "
+        "pieceSet TEXT NOT NULL DEFAULT '', "
+        "playerName TEXT NOT NULL, "
+        "score INTEGER NOT NULL, "
+        "level INTEGER NOT NULL, "
+        "lines INTEGER NOT NULL, "
+        "date TEXT NOT NULL"
+        ")";
+
+    if (!query.exec(createDailyTableSql)) {
+        qWarning() << "Create daily table failed:" << query.lastError().text();
+        return false;
+    }
+
+    // 旧版本的表没有随机模式和方块集合列，补上（旧记录的规则未知，不再参与排名）
+    bool hasRules = false;
+    if (query.exec("PRAGMA table_info(daily_scores)")) {
+        while (query.next()) {
+            if (query.value(1).toString() == "mode") {
+                hasRules = true;
+            }
+        }
+    }
+    if (!hasRules) {
+        if (!query.exec("ALTER TABLE daily_scores ADD COLUMN mode TEXT NOT NULL DEFAULT ''")
+            || !query.exec("ALTER TABLE daily_scores ADD COLUMN pieceSet TEXT NOT NULL DEFAULT ''")) {
+            qWarning() << "Upgrade daily table failed:" << query.lastError().text();
+            return false;
+        }
+    }
+
+    // (seed, mode, pieceSet, score) 联合索引：同一排行榜的排名和前N名查询只扫描索引中的一段
+    query.exec("DROP INDEX IF EXISTS idx_daily_scores_seed_score");
+    if (!query.exec("CREATE INDEX IF NOT EXISTS idx_daily_scores_key_score "
+                    "ON daily_scores (seed, mode, pieceSet, score DESC)")) {
+        qWarning() << "Create daily index failed:" << query.lastError().text();
+        return false;
+    }
+
     return true;
 }
 
@@ -136,6 +180,95 @@ void ScoreManager::resetHighScores()
     m_highScores.clear();
 }
 
+int ScoreManager::addDailyScore(const DailyKey& key, int score, int level, int lines, const QString& playerName)
+{
+    QSqlQuery query;
+    query.prepare("INSERT INTO daily_scores (seed, mode, pieceSet, playerName, score, level, lines, date) "
+                  "VALUES (:seed, :mode, :pieceSet, :playerName, :score, :level, :lines, :date)");
+    query.bindValue(":seed", static_cast<qint64>(key.seed)); // SQLite 整数为有符号64位
+    query.bindValue(":mode", key.mode);
+    query.bindValue(":pieceSet", key.pieceSet);
+    query.bindValue(":playerName", playerName);
+    query.bindValue(":score", score);
+    query.bindValue(":level", level);
+    query.bindValue(":lines", lines);
+    query.bindValue(":date", QDateTime::currentDateTime().toString(Qt::ISODate));
+
+    if (!query.exec()) {
+        qWarning() << "Insert daily score failed:" << query.lastError().text();
+        return 0;
+    }
+
+    return getDailyRank(key, score);
+}
+
+QVector<ScoreManager::HighScore> ScoreManager::getDailyHighScores(const DailyKey& key, int count) const
+{
+    QVector<HighScore> scores;
+
+    QSqlQuery query;
+    query.prepare("SELECT playerName, score, level, lines, date FROM daily_scores "
+                  "WHERE seed = :seed AND mode = :mode AND pieceSet = :pieceSet "
+                  "ORDER BY score DESC LIMIT :limit");
+    query.bindValue(":seed", static_cast<qint64>(key.seed));
+    query.bindValue(":mode", key.mode);
+    query.bindValue(":pieceSet", key.pieceSet);
+    query.bindValue(":limit", count);
+
+    if (!query.exec()) {
+        qWarning() << "Load daily scores failed:" << query.lastError().text();
+        return scores;
+    }
+
+    while (query.next()) {
+        HighScore score;
+        score.playerName = query.value(0).toString();
+        score.score = query.value(1).toInt();
+        score.level = query.value(2).toInt();
+        score.lines = query.value(3).toInt();
+        score.date = QDateTime::fromString(query.value(4).toString(), Qt::ISODate);
+
+        scores.append(score);
+    }
+
+    return scores;
+}
+
+int ScoreManager::getDailyRank(const DailyKey& key, int score) const
+{
+    // 名次 = 同一排行榜中分数更高的记录数 + 1
+    QSqlQuery query;
+    query.prepare("SELECT COUNT(*) FROM daily_scores "
+                  "WHERE seed = :seed AND mode = :mode AND pieceSet = :pieceSet AND score > :score");
+    query.bindValue(":seed", static_cast<qint64>(key.seed));
+    query.bindValue(":mode", key.mode);
+    query.bindValue(":pieceSet", key.pieceSet);
+    query.bindValue(":score", score);
+
+    if (!query.exec() || !query.next()) {
+        qWarning() << "Query daily rank failed:" << query.lastError().text();
+        return 0;
+    }
+
+    return query.value(0).toInt() + 1;
+}
+
+int ScoreManager::getDailyPlayerCount(const DailyKey& key) const
+{
+    QSqlQuery query;
+    query.prepare("SELECT COUNT(*) FROM daily_scores WHERE seed = :seed AND mode = :mode AND pieceSet = :pieceSet");
+    query.bindValue(":seed", static_cast<qint64>(key.seed));
+    query.bindValue(":mode", key.mode);
+    query.bindValue(":pieceSet", key.pieceSet);
+
+    if (!query.exec() || !query.next()) {
+        qWarning() << "Query daily player count failed:" << query.lastError().text();
+        return 0;
+    }
+
+    return query.value(0).toInt();
+}
+
 bool ScoreManager::loadHighScores()
 {
     QSqlQuery query("SELECT playerName, score, level, lines, date FROM highscores "
@@ -33,6 +33,21 @@ public:
     QVector<HighScore> getHighScores(int count = 10) const;
     void resetHighScores();
 
+    // 每日挑战排行榜的区分条件：方块序列由种子、随机模式和方块集合共同决定，三者相同的成绩才互相排名
+    struct DailyKey {
+        quint64 seed;
+        QString mode;       // 随机模式（如 "7-bag"）
+        QString pieceSet;   // 方块集合名称或路径
+
+        DailyKey() : seed(0) {}
+    };
+
+    // 每日挑战排行榜（返回本次成绩的名次）
+    int addDailyScore(const DailyKey& key, int score, int level, int lines, const QString& playerName = "Player");
+    QVector<HighScore> getDailyHighScores(const DailyKey& key, int count = 10) const;
+    int getDailyRank(const DailyKey& key, int score) const;
+    int getDailyPlayerCount(const DailyKey& key) const;
+
     // 数据库操作
     bool initDatabase();
     bool loadHighScores();
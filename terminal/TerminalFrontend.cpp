@@ -0,0 +1,243 @@
+#include "TerminalFrontend.h"
+
+namespace {
+
+const quint8 BORDER_COLOR = 244;    // 边框和标签（灰色）
+const quint8 TEXT_COLOR = 255;      // 数值（白色）
+
+} // namespace
+
+TerminalFrontend::TerminalFrontend(QObject* parent)
+    : QObject(parent)
+    , m_dirty(true)
+    , m_bytes(0)
+    , m_frames(0)
+    , m_bytesPerFrame(0)
+{
+    m_frameTimer.setInterval(FRAME_INTERVAL_MS);
+    m_frameTimer.setTimerType(Qt::PreciseTimer);
+    connect(&m_frameTimer, &QTimer::timeout, this, &TerminalFrontend::onFrame);
+
+    m_softDropTimer.setSingleShot(true);
+    m_softDropTimer.setInterval(SOFT_DROP_RELEASE_MS);
+    connect(&m_softDropTimer, &QTimer::timeout, this, [this]() {
+        m_engine.queueInput(InputHandler::ACTION_SOFT_DROP, false, GameClock::now());
+    });
+
+    connect(&m_input, &TerminalInput::actionTriggered, this, &TerminalFrontend::onAction);
+    connect(&m_input, &TerminalInput::quitRequested, this, &TerminalFrontend::onQuit);
+
+    connect(&m_engine, &GameEngine::gameFieldChanged, this, &TerminalFrontend::markDirty);
+    connect(&m_engine, &GameEngine::currentBlockChanged, this, &TerminalFrontend::markDirty);
+    connect(&m_engine, &GameEngine::nextBlockChanged, this, &TerminalFrontend::markDirty);
+    connect(&m_engine, &GameEngine::holdBlockChanged, this, &TerminalFrontend::markDirty);
+    connect(&m_engine, &GameEngine::gameStatsUpdated, this, &TerminalFrontend::markDirty);
+    connect(&m_engine, &GameEngine::gameStateChanged, this, &TerminalFrontend::markDirty);
+}
+
+TerminalFrontend::~TerminalFrontend()
+{
+    m_screen.end();
+    m_input.end();
+}
+
+bool TerminalFrontend::start()
+{
+    if (!m_input.begin()) {
+        return false;
+    }
+    m_screen.begin();
+
+    if (!m_engine.initialize()) {
+        qWarning() << "Failed to initialize game engine";
+        return false;
+    }
+    m_engine.startGame();
+
+    m_statsClock.start();
+    m_frameTimer.start();
+    return true;
+}
+
+void TerminalFrontend::onQuit()
+{
+    m_frameTimer.stop();
+    m_engine.endGame();
+    m_screen.end();
+    m_input.end();
+    emit finished();
+}
+
+void TerminalFrontend::onAction(InputHandler::GameAction action)
+{
+    // 读到按键时取时间戳，游戏操作交给引擎按时间戳顺序应用
+    const qint64 timestamp = GameClock::now();
+
+    switch (action) {
+    case InputHandler::ACTION_SOFT_DROP:
+        // 按住下键时终端持续发送重复按键，每次都推迟松开
+        m_engine.queueInput(action, true, timestamp);
+        m_softDropTimer.start();
+        break;
+    case InputHandler::ACTION_MOVE_LEFT:
+    case InputHandler::ACTION_MOVE_RIGHT:
+    case InputHandler::ACTION_ROTATE_CW:
+    case InputHandler::ACTION_ROTATE_CCW:
+    case InputHandler::ACTION_HOLD:
+        // 终端没有释放事件，按住时由终端的按键重复产生连续移动，引擎不做自动重复；
+        // 旋转和暂存也立即释放，避免按住状态一直保留到之后生成的方块（IRS/IHS）
+        m_engine.queueInput(action, true, timestamp);
+        m_engine.queueInput(action, false, timestamp);
+        break;
+    case InputHandler::ACTION_PAUSE:
+        if (m_engine.getGameState() == GameEngine::STATE_RUNNING) {
+            m_engine.pauseGame();
+        } else if (m_engine.getGameState() == GameEngine::STATE_PAUSED) {
+            m_engine.resumeGame();
+        }
+        break;
+    case InputHandler::ACTION_RESTART:
+        m_engine.restartGame();
+        break;
+    default:
+        m_engine.queueInput(action, true, timestamp);
+        break;
+    }
+}
+
+void TerminalFrontend::onFrame()
+{
+    // 终端尺寸变化时全部重绘
+    if (m_screen.updateSize()) {
+        m_dirty = true;
+    }
+
+    // 每秒更新一次平均每帧字节数
+    if (m_statsClock.elapsed() >= 1000) {
+        const int bytesPerFrame = m_frames > 0 ? static_cast<int>(m_bytes / m_frames) : 0;
+        if (bytesPerFrame != m_bytesPerFrame) {
+            m_bytesPerFrame = bytesPerFrame;
+            m_dirty = true;
+        }
+        m_bytes = 0;
+        m_frames = 0;
+        m_statsClock.restart();
+    }
+
+    if (!m_dirty) return;
+    m_dirty = false;
+
+    compose();
+    const int bytes = m_screen.present();
+    if (bytes > 0) {
+        m_bytes += bytes;
+        m_frames++;
+    }
+}
+
+void TerminalFrontend::drawBorder(int left, int top, int width, int height)
+{
+    for (int x = left; x < left + width; ++x) {
+        m_screen.put(x, top, '-', BORDER_COLOR, TerminalScreen::DEFAULT_COLOR);
+        m_screen.put(x, top + height - 1, '-', BORDER_COLOR, TerminalScreen::DEFAULT_COLOR);
+    }
+    for (int y = top; y < top + height; ++y) {
+        const char ch = (y == top || y == top + height - 1) ? '+' : '|';
+        m_screen.put(left, y, ch, BORDER_COLOR, TerminalScreen::DEFAULT_COLOR);
+        m_screen.put(left + width - 1, y, ch, BORDER_COLOR, TerminalScreen::DEFAULT_COLOR);
+    }
+}
+
+void TerminalFrontend::drawCell(int column, int row, const QColor& color, bool ghost)
+{
+    // 每格占两列，接近正方形
+    const quint8 index = TerminalScreen::toPaletteIndex(color);
+    if (ghost) {
+        m_screen.put(column, row, '[', index, TerminalScreen::DEFAULT_COLOR);
+        m_screen.put(column + 1, row, ']', index, TerminalScreen::DEFAULT_COLOR);
+    } else {
+        m_screen.put(column, row, ' ', TerminalScreen::DEFAULT_COLOR, index);
+        m_screen.put(column + 1, row, ' ', TerminalScreen::DEFAULT_COLOR, index);
+    }
+}
+
+void TerminalFrontend::drawPreview(int column, int row, const Block& block)
+{
+    if (!block.isValid()) return;
+
+    const PieceSet::Rotation& rotation = block.getRotationData();
+    const QColor color = block.getColor();
+    for (int i = 0; i < rotation.cellCount; ++i) {
+        const int x = rotation.cells[i].x - rotation.bounds.left();
+        const int y = rotation.cells[i].y - rotation.bounds.top();
+        drawCell(column + x * 2, row + y, color, false);
+    }
+}
+
+void TerminalFrontend::compose()
+{
+    m_screen.clear();
+
+    const GameField& field = m_engine.getGameField();
+    const int left = 2;
+    const int top = 1;
+    const int boardWidth = field.getWidth() * 2 + 2;
+    const int boardHeight = field.getHeight() + 2;
+
+    // 场地
+    drawBorder(left, top, boardWidth, boardHeight);
+    for (int y = 0; y < field.getHeight(); ++y) {
+        if (field.getRowMask(y) == 0) continue;
+        for (int x = 0; x < field.getWidth(); ++x) {
+            if (!field.isCellEmpty(x, y)) {
+                drawCell(left + 1 + x * 2, top + 1 + y, field.getCellColor(x, y), false);
+            }
+        }
+    }
+
+    // 幽灵方块和当前方块
+    const Block& current = m_engine.getCurrentBlock();
+    if (current.isValid() && m_engine.getGameState() == GameEngine::STATE_RUNNING) {
+        if (GHOST_BLOCK_ENABLED) {
+            const Block ghost = m_engine.getGhostBlock();
+            for (const Position& cell : ghost.getOccupiedCells()) {
+                if (cell.y >= 0 && field.isCellEmpty(cell.x, cell.y)) {
+                    drawCell(left + 1 + cell.x * 2, top + 1 + cell.y, ghost.getColor(), true);
+                }
+            }
+        }
+        for (const Position& cell : current.getOccupiedCells()) {
+            if (cell.y >= 0) {
+                drawCell(left + 1 + cell.x * 2, top + 1 + cell.y, current.getColor(), false);
+            }
+        }
+    }
+
+    // 信息栏
+    const int panel = left + boardWidth + 3;
+    const GameStats& stats = m_engine.getGameStats();
+    m_screen.drawText(panel, top, "SCORE", BORDER_COLOR);
+    m_screen.drawText(panel, top + 1, QString::number(stats.score), TEXT_COLOR);
+    m_screen.drawText(panel, top + 3, "LEVEL", BORDER_COLOR);
+    m_screen.drawText(panel, top + 4, QString::number(stats.level), TEXT_COLOR);
+    m_screen.drawText(panel, top + 6, "LINES", BORDER_COLOR);
+    m_screen.drawText(panel, top + 7, QString::number(stats.linesCleared), TEXT_COLOR);
+
+    m_screen.drawText(panel, top + 9, "NEXT", BORDER_COLOR);
+    drawPreview(panel, top + 10, m_engine.getNextBlock());
+    m_screen.drawText(panel, top + 14, "HOLD", BORDER_COLOR);
+    drawPreview(panel, top + 15, m_engine.getHoldBlock());
+
+    m_screen.drawText(panel, top + boardHeight - 3, "arrows move/rotate  space drop", BORDER_COLOR);
+    m_screen.drawText(panel, top + boardHeight - 2, "z/x rotate  c hold  p pause  q quit", BORDER_COLOR);
+    m_screen.drawText(panel, top + boardHeight - 1, QString("%1 B/frame").arg(m_bytesPerFrame), BORDER_COLOR);
+
+    // 状态提示
+    const int messageRow = top + boardHeight / 2;
+    if (m_engine.getGameState() == GameEngine::STATE_PAUSED) {
+        m_screen.drawText(left + boardWidth / 2 - 3, messageRow, "PAUSED", TEXT_COLOR);
+    } else if (m_engine.getGameState() == GameEngine::STATE_GAME_OVER) {
+        m_screen.drawText(left + boardWidth / 2 - 4, messageRow, "GAME OVER", TEXT_COLOR);
+        m_screen.drawText(left + boardWidth / 2 - 6, messageRow + 1, "r restart q quit", TEXT_COLOR);
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef TERMINALFRONTEND_H
+#define TERMINALFRONTEND_H
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include "GameEngine.h"
+#include "TerminalScreen.h"
+#include "TerminalInput.h"
+
+// 终端前端：只依赖游戏核心，用 ANSI 转义序列绘制场地和信息栏
+// 引擎信号只标记画面需要更新，每个帧周期最多合成一次，输出只包含与上一帧不同的字符格
+class TerminalFrontend : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int FRAME_INTERVAL_MS = 16;        // 帧周期（约 60 FPS）
+    static constexpr int SOFT_DROP_RELEASE_MS = 120;    // 终端不报告按键释放，超过此时间没有再收到下键视为松开
+
+    explicit TerminalFrontend(QObject* parent = nullptr);
+    ~TerminalFrontend();
+
+    // 进入终端全屏模式并开始游戏，标准输入不是终端时返回 false
+    bool start();
+
+signals:
+    void finished();
+
+private slots:
+    void onAction(InputHandler::GameAction action);
+    void onFrame();
+    void onQuit();
+    void markDirty() { m_dirty = true; }
+
+private:
+    void compose();                                     // 按引擎状态绘制整个画面到后台缓冲
+    void drawBorder(int left, int top, int width, int height);
+    void drawCell(int column, int row, const QColor& color, bool ghost);
+    void drawPreview(int column, int row, const Block& block);  // 在 4x2 格区域中绘制方块
+
+    GameEngine m_engine;
+    TerminalScreen m_screen;
+    TerminalInput m_input;
+    QTimer m_frameTimer;
+    QTimer m_softDropTimer;
+    bool m_dirty;                       // 引擎状态变化后尚未绘制
+
+    // 输出统计（显示在信息栏，用于确认慢速连接下的带宽）
+    QElapsedTimer m_statsClock;
+    qint64 m_bytes;                     // 本统计周期写出的字节数
+    int m_frames;                       // 本统计周期输出的帧数
+    int m_bytesPerFrame;                // 上一统计周期的平均每帧字节数
+};
+
+#endif // TERMINALFRONTEND_H
@@ -0,0 +1,150 @@
+#include <unistd.h>
+#include <QDebug>
+#include "TerminalInput.h"
+
+TerminalInput::TerminalInput(QObject* parent)
+    : QObject(parent)
+    , m_notifier(nullptr)
+    , m_savedSettings()
+    , m_active(false)
+{
+}
+
+TerminalInput::~TerminalInput()
+{
+    end();
+}
+
+bool TerminalInput::begin()
+{
+    if (m_active) return true;
+
+    if (!isatty(STDIN_FILENO) || tcgetattr(STDIN_FILENO, &m_savedSettings) != 0) {
+        qWarning() << "Standard input is not a terminal";
+        return false;
+    }
+
+    // 原始模式：关闭回显、行缓冲和 Ctrl-C 等信号（由本程序处理退出），读取不阻塞
+    termios raw = m_savedSettings;
+    raw.c_iflag &= ~(IXON | ICRNL);
+    raw.c_lflag &= ~(ECHO | ICANON | ISIG | IEXTEN);
+    raw.c_cc[VMIN] = 0;
+    raw.c_cc[VTIME] = 0;
+    if (tcsetattr(STDIN_FILENO, TCSANOW, &raw) != 0) {
+        qWarning() << "Failed to switch terminal to raw mode";
+        return false;
+    }
+    m_active = true;
+
+    m_notifier = new QSocketNotifier(STDIN_FILENO, QSocketNotifier::Read, this);
+    connect(m_notifier, &QSocketNotifier::activated, this, &TerminalInput::onReadable);
+    return true;
+}
+
+void TerminalInput::end()
+{
+    if (!m_active) return;
+    m_active = false;
+
+    delete m_notifier;
+    m_notifier = nullptr;
+    tcsetattr(STDIN_FILENO, TCSANOW, &m_savedSettings);
+}
+
+void TerminalInput::onReadable()
+{
+    char buffer[256];
+    const ssize_t count = ::read(STDIN_FILENO, buffer, sizeof(buffer));
+    if (count <= 0) return;
+    m_pending.append(buffer, static_cast<int>(count));
+
+    int offset = 0;
+    while (offset < m_pending.size()) {
+        const int used = parseKey(m_pending, offset);
+        if (used == 0) break;
+        offset += used;
+    }
+    m_pending.remove(0, offset);
+}
+
+int TerminalInput::parseKey(const QByteArray& buffer, int offset)
+{
+    const char ch = buffer[offset];
+
+    // 转义序列：方向键为 ESC [ A-D（部分终端为 ESC O A-D）
+    if (ch == '\x1b') {
+        if (offset + 1 >= buffer.size()) {
+            return 0;
+        }
+        const char kind = buffer[offset + 1];
+
+        // SS3 序列固定为 3 字节
+        if (kind == 'O') {
+            if (offset + 2 >= buffer.size()) {
+                return 0;
+            }
+            emitArrow(buffer[offset + 2]);
+            return 3;
+        }
+        if (kind != '[') {
+            return 1;  // 单独的 ESC 忽略
+        }
+
+        // CSI 序列：参数字节 0x30-0x3F、中间字节 0x20-0x2F，以 0x40-0x7E 的结束字节结尾，
+        // 整个序列一起消耗（如 Ctrl+方向键 ESC[1;5C、PgUp ESC[5~），只处理不带参数的方向键
+        int end = offset + 2;
+        while (end < buffer.size()) {
+            const uchar byte = static_cast<uchar>(buffer[end]);
+            if (byte >= 0x40 && byte <= 0x7e) {
+                if (end == offset + 2) {
+                    emitArrow(buffer[end]);
+                }
+                return end - offset + 1;
+            }
+            if (byte < 0x20 || byte > 0x3f) {
+                return end - offset;  // 格式错误，丢弃已读取的部分
+            }
+            ++end;
+        }
+        return 0;
+    }
+
+    switch (ch) {
+    case ' ':
+        emit actionTriggered(InputHandler::ACTION_HARD_DROP);
+        break;
+    case 'z': case 'Z':
+        emit actionTriggered(InputHandler::ACTION_ROTATE_CCW);
+        break;
+    case 'x': case 'X':
+        emit actionTriggered(InputHandler::ACTION_ROTATE_CW);
+        break;
+    case 'c': case 'C':
+        emit actionTriggered(InputHandler::ACTION_HOLD);
+        break;
+    case 'p': case 'P':
+        emit actionTriggered(InputHandler::ACTION_PAUSE);
+        break;
+    case 'r': case 'R':
+        emit actionTriggered(InputHandler::ACTION_RESTART);
+        break;
+    case 'q': case 'Q':
+    case '\x03':  // Ctrl-C
+        emit quitRequested();
+        break;
+    default:
+        break;
+    }
+    return 1;
+}
+
+void TerminalInput::emitArrow(char code)
+{
+    switch (code) {
+    case 'A': emit actionTriggered(InputHandler::ACTION_ROTATE_CW); break;
+    case 'B': emit actionTriggered(InputHandler::ACTION_SOFT_DROP); break;
+    case 'C': emit actionTriggered(InputHandler::ACTION_MOVE_RIGHT); break;
+    case 'D': emit actionTriggered(InputHandler::ACTION_MOVE_LEFT); break;
+    default: break;
+    }
+}
@@ -0,0 +1,42 @@
+#ifndef TERMINALINPUT_H
+#define TERMINALINPUT_H
+#include <QObject>
+#include <QByteArray>
+#include <QSocketNotifier>
+#include <termios.h>
+#include "InputHandler.h"
+
+// 终端键盘输入
+// 标准输入切换为原始模式（不回显、不按行缓冲、不产生信号），由 QSocketNotifier 在事件循环中读取，
+// 方向键等转义序列和普通按键映射为游戏操作；终端不报告按键释放
+class TerminalInput : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit TerminalInput(QObject* parent = nullptr);
+    ~TerminalInput();
+
+    // 进入原始模式并开始读取，失败时（例如标准输入不是终端）返回 false
+    bool begin();
+    // 恢复终端设置
+    void end();
+
+signals:
+    void actionTriggered(InputHandler::GameAction action);
+    void quitRequested();
+
+private slots:
+    void onReadable();
+
+private:
+    int parseKey(const QByteArray& buffer, int offset);  // 解析一个按键，返回消耗的字节数（不完整时返回 0）
+    void emitArrow(char code);                           // 方向键（CSI/SS3 序列的结束字节）对应的操作
+
+    QSocketNotifier* m_notifier;
+    termios m_savedSettings;        // 进入原始模式前的设置
+    bool m_active;
+    QByteArray m_pending;           // 尚未解析完的字节（转义序列可能分多次到达）
+};
+
+#endif // TERMINALINPUT_H
@@ -0,0 +1,211 @@
+#include <sys/ioctl.h>
+#include <unistd.h>
+#include <cerrno>
+#include "TerminalScreen.h"
+
+namespace {
+
+// 6x6x6 色立方每个分量的取值
+const int CUBE_LEVELS[6] = { 0, 95, 135, 175, 215, 255 };
+
+inline int cubeLevel(int value)
+{
+    return value < 48 ? 0 : value < 115 ? 1 : (value - 35) / 40;
+}
+
+inline int distance(int r1, int g1, int b1, int r2, int g2, int b2)
+{
+    return (r1 - r2) * (r1 - r2) + (g1 - g2) * (g1 - g2) + (b1 - b2) * (b1 - b2);
+}
+
+} // namespace
+
+TerminalScreen::TerminalScreen()
+    : m_columns(0)
+    , m_rows(0)
+    , m_fullRedraw(true)
+    , m_active(false)
+    , m_currentForeground(DEFAULT_COLOR)
+    , m_currentBackground(DEFAULT_COLOR)
+{
+}
+
+TerminalScreen::~TerminalScreen()
+{
+    end();
+}
+
+void TerminalScreen::begin()
+{
+    if (m_active) return;
+    m_active = true;
+
+    // 备用屏幕、隐藏光标、关闭自动换行（写到右下角时不滚屏）
+    writeAll("\x1b[?1049h\x1b[?25l\x1b[?7l");
+    m_fullRedraw = true;
+    updateSize();
+}
+
+void TerminalScreen::end()
+{
+    if (!m_active) return;
+    m_active = false;
+
+    writeAll("\x1b[0m\x1b[?7h\x1b[?25h\x1b[?1049l");
+}
+
+bool TerminalScreen::updateSize()
+{
+    winsize size;
+    int columns = 80;
+    int rows = 24;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0 && size.ws_col > 0 && size.ws_row > 0) {
+        columns = size.ws_col;
+        rows = size.ws_row;
+    }
+
+    if (columns == m_columns && rows == m_rows) {
+        return false;
+    }
+
+    m_columns = columns;
+    m_rows = rows;
+    m_back.fill(Cell{ ' ', DEFAULT_COLOR, DEFAULT_COLOR }, columns * rows);
+    m_front = m_back;
+    m_fullRedraw = true;
+    return true;
+}
+
+void TerminalScreen::clear()
+{
+    m_back.fill(Cell{ ' ', DEFAULT_COLOR, DEFAULT_COLOR });
+}
+
+void TerminalScreen::put(int column, int row, char ch, quint8 foreground, quint8 background)
+{
+    if (column < 0 || column >= m_columns || row < 0 || row >= m_rows) return;
+    m_back[row * m_columns + column] = Cell{ ch, foreground, background };
+}
+
+void TerminalScreen::drawText(int column, int row, const QString& text, quint8 foreground, quint8 background)
+{
+    // 每格一个字节，只支持 ASCII
+    const QByteArray latin = text.toLatin1();
+    for (int i = 0; i < latin.size(); ++i) {
+        put(column + i, row, latin[i], foreground, background);
+    }
+}
+
+int TerminalScreen::present()
+{
+    m_output.clear();
+
+    // 清屏后终端上的画面为空白，与空白缓冲比较
+    if (m_fullRedraw) {
+        m_output += "\x1b[0m\x1b[2J";
+        m_currentForeground = DEFAULT_COLOR;
+        m_currentBackground = DEFAULT_COLOR;
+        m_front.fill(Cell{ ' ', DEFAULT_COLOR, DEFAULT_COLOR });
+        m_fullRedraw = false;
+    }
+
+    int cursorRow = -1;
+    int cursorColumn = -1;
+    for (int row = 0; row < m_rows; ++row) {
+        for (int column = 0; column < m_columns; ++column) {
+            const int index = row * m_columns + column;
+            const Cell& cell = m_back[index];
+            if (cell == m_front[index]) continue;
+
+            // 光标不在该格时才移动
+            if (row != cursorRow || column != cursorColumn) {
+                m_output += "\x1b[";
+                m_output += QByteArray::number(row + 1);
+                m_output += ';';
+                m_output += QByteArray::number(column + 1);
+                m_output += 'H';
+            }
+
+            appendColor(cell.foreground, cell.background);
+            m_output += cell.ch;
+            m_front[index] = cell;
+
+            cursorRow = row;
+            cursorColumn = column + 1;
+        }
+    }
+
+    if (!m_output.isEmpty()) {
+        writeAll(m_output);
+    }
+    return m_output.size();
+}
+
+void TerminalScreen::appendColor(quint8 foreground, quint8 background)
+{
+    if (foreground == m_currentForeground && background == m_currentBackground) return;
+
+    m_output += "\x1b[";
+    if (foreground != m_currentForeground) {
+        if (foreground == DEFAULT_COLOR) {
+            m_output += "39";
+        } else {
+            m_output += "38;5;";
+            m_output += QByteArray::number(foreground);
+        }
+        if (background != m_currentBackground) {
+            m_output += ';';
+        }
+    }
+    if (background != m_currentBackground) {
+        if (background == DEFAULT_COLOR) {
+            m_output += "49";
+        } else {
+            m_output += "48;5;";
+            m_output += QByteArray::number(background);
+        }
+    }
+    m_output += 'm';
+
+    m_currentForeground = foreground;
+    m_currentBackground = background;
+}
+
+void TerminalScreen::writeAll(const QByteArray& data)
+{
+    const char* bytes = data.constData();
+    qint64 left = data.size();
+    while (left > 0) {
+        const ssize_t written = ::write(STDOUT_FILENO, bytes, static_cast<size_t>(left));
+        if (written < 0) {
+            if (errno == EINTR || errno == EAGAIN) continue;
+            return;
+        }
+        bytes += written;
+        left -= written;
+    }
+}
+
+quint8 TerminalScreen::toPaletteIndex(const QColor& color)
+{
+    const int r = color.red();
+    const int g = color.green();
+    const int b = color.blue();
+
+    // 色立方中最接近的颜色
+    const int cr = cubeLevel(r);
+    const int cg = cubeLevel(g);
+    const int cb = cubeLevel(b);
+    const int cubeDistance = distance(r, g, b, CUBE_LEVELS[cr], CUBE_LEVELS[cg], CUBE_LEVELS[cb]);
+
+    // 灰阶中最接近的颜色（232-255，8 到 238）
+    const int average = (r + g + b) / 3;
+    const int grayIndex = qBound(0, (average - 3) / 10, 23);
+    const int gray = 8 + grayIndex * 10;
+    const int grayDistance = distance(r, g, b, gray, gray, gray);
+
+    if (grayDistance < cubeDistance) {
+        return static_cast<quint8>(232 + grayIndex);
+    }
+    return static_cast<quint8>(16 + cr * 36 + cg * 6 + cb);
+}
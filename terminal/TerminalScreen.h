@@ -0,0 +1,67 @@
+#ifndef TERMINALSCREEN_H
+#define TERMINALSCREEN_H
+#include <QByteArray>
+#include <QColor>
+#include <QString>
+#include <QVector>
+
+// 终端画面缓冲
+// 每帧先在后台缓冲中绘制完整画面，present() 时只输出与上次实际输出的画面不同的字符格：
+// 光标只在不连续时移动，颜色属性只在变化时切换（256 色），整帧拼成一次 write
+class TerminalScreen
+{
+public:
+    static constexpr quint8 DEFAULT_COLOR = 0xff;  // 终端默认颜色（不是调色板下标）
+
+    TerminalScreen();
+    ~TerminalScreen();
+
+    // 进入和退出全屏模式（备用屏幕、隐藏光标），退出时恢复终端
+    void begin();
+    void end();
+
+    // 读取终端尺寸，变化时清空缓冲并在下一帧全部重绘
+    bool updateSize();
+    int getColumns() const { return m_columns; }
+    int getRows() const { return m_rows; }
+
+    // 绘制到后台缓冲（超出画面的部分忽略）
+    void clear();
+    void put(int column, int row, char ch, quint8 foreground, quint8 background);
+    void drawText(int column, int row, const QString& text, quint8 foreground = DEFAULT_COLOR, quint8 background = DEFAULT_COLOR);
+
+    // 输出变化的字符格，返回本帧写出的字节数
+    int present();
+
+    // 颜色转换为 256 色调色板下标（6x6x6 色立方和灰阶中最接近的一个）
+    static quint8 toPaletteIndex(const QColor& color);
+
+private:
+    struct Cell {
+        char ch;
+        quint8 foreground;
+        quint8 background;
+
+        bool operator==(const Cell& other) const {
+            return ch == other.ch && foreground == other.foreground && background == other.background;
+        }
+        bool operator!=(const Cell& other) const { return !(*this == other); }
+    };
+
+    void appendColor(quint8 foreground, quint8 background);
+    void writeAll(const QByteArray& data);
+
+    int m_columns;
+    int m_rows;
+    QVector<Cell> m_back;           // 本帧画面
+    QVector<Cell> m_front;          // 终端上当前的画面
+    bool m_fullRedraw;              // 下一帧清屏并全部输出
+    bool m_active;
+
+    // present() 期间的输出状态
+    QByteArray m_output;            // 复用的输出缓冲
+    quint8 m_currentForeground;
+    quint8 m_currentBackground;
+};
+
+#endif // TERMINALSCREEN_H
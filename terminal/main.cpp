@@ -0,0 +1,39 @@
+// 终端版俄罗斯方块：只链接游戏核心，在没有图形界面的环境（CI、SSH）中运行
+#include <QCoreApplication>
+#include <unistd.h>
+#include <cstdio>
+#include "GameConfig.h"
+#include "TerminalFrontend.h"
+
+namespace {
+
+// 日志会打乱画面：调试信息丢弃，其他信息只在标准错误被重定向时输出
+void messageHandler(QtMsgType type, const QMessageLogContext& context, const QString& message)
+{
+    Q_UNUSED(context)
+    if (type == QtDebugMsg || isatty(STDERR_FILENO)) return;
+    fprintf(stderr, "%s\n", message.toLocal8Bit().constData());
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("TetrisTerminal");
+
+    if (!GAME_CONFIG.initialize("./configData/user_config.ini")) {
+        fprintf(stderr, "配置文件加载失败！但继续运行...\n");
+    }
+
+    qInstallMessageHandler(messageHandler);
+
+    TerminalFrontend frontend;
+    QObject::connect(&frontend, &TerminalFrontend::finished, &app, &QCoreApplication::quit);
+    if (!frontend.start()) {
+        fprintf(stderr, "标准输入不是终端\n");
+        return 1;
+    }
+
+    return app.exec();
+}
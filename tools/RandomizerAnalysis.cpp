@@ -0,0 +1,299 @@
+// 随机化算法统计工具
+// 多线程生成大量方块序列，统计分布、配对/三连频率和干旱（两次出现之间的间隔）
+//
+// 每个线程生成一条独立的随机流（同一种子跳转得到），各流不首尾相接：
+// 配对、三连和间隔都只在流内统计，不存在跨越线程边界的样本。
+// 每条流开头到某类型首次出现之前的间隔起点未知（被截断），不计入间隔直方图；
+// 流末尾某类型最后一次出现之后尚未结束的干旱单独记录为“末尾干旱”，同样不计入直方图
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <algorithm>
+#include <functional>
+#include <thread>
+#include <vector>
+#include "Randomizer.h"
+#include "BlockFactory.h"
+
+namespace {
+
+constexpr int MAX_GAP = 1024;  // 间隔直方图上限，超出部分计入最后一格
+
+// 单条随机流的统计结果，每个线程独占一份，结束后再合并
+struct StreamStats {
+    int typeCount = 0;
+    quint64 pieces = 0;
+    quint64 pairSamples = 0;            // 配对样本数
+    quint64 tripleSamples = 0;          // 三连样本数
+    std::vector<quint64> counts;        // 各类型出现次数
+    std::vector<quint64> pairs;         // 相邻两个方块的组合次数
+    std::vector<quint64> triples;       // 相邻三个方块的组合次数
+    std::vector<quint64> gapHistogram;  // 各类型的间隔直方图
+    std::vector<quint64> maxGap;        // 各类型的最长间隔（完整间隔）
+    std::vector<quint64> maxOpenGap;    // 各类型在流末尾尚未结束的最长干旱（下限）
+
+    explicit StreamStats(int types = 0)
+        : typeCount(types)
+        , counts(types, 0)
+        , pairs(types * types, 0)
+        , triples(types * types * types, 0)
+        , gapHistogram(types * (MAX_GAP + 1), 0)
+        , maxGap(types, 0)
+        , maxOpenGap(types, 0)
+    {
+    }
+
+    void merge(const StreamStats& other)
+    {
+        pieces += other.pieces;
+        pairSamples += other.pairSamples;
+        tripleSamples += other.tripleSamples;
+        for (size_t i = 0; i < counts.size(); ++i) counts[i] += other.counts[i];
+        for (size_t i = 0; i < pairs.size(); ++i) pairs[i] += other.pairs[i];
+        for (size_t i = 0; i < triples.size(); ++i) triples[i] += other.triples[i];
+        for (size_t i = 0; i < gapHistogram.size(); ++i) gapHistogram[i] += other.gapHistogram[i];
+        for (size_t i = 0; i < maxGap.size(); ++i) maxGap[i] = std::max(maxGap[i], other.maxGap[i]);
+        for (size_t i = 0; i < maxOpenGap.size(); ++i) maxOpenGap[i] = std::max(maxOpenGap[i], other.maxOpenGap[i]);
+    }
+};
+
+// 生成一条随机流并统计
+void runStream(Randomizer randomizer, quint64 pieces, StreamStats& stats)
+{
+    const int n = stats.typeCount;
+    quint64* counts = stats.counts.data();
+    quint64* pairs = stats.pairs.data();
+    quint64* triples = stats.triples.data();
+    quint64* histogram = stats.gapHistogram.data();
+    quint64* maxGap = stats.maxGap.data();
+
+    // lastSeen 保存上次出现位置+1，0 表示本流中尚未出现（首个间隔被截断，不计入）
+    quint64 lastSeen[Randomizer::MAX_TYPES] = {};
+    int prev2 = 0;
+    int prev1 = 0;
+
+    for (quint64 i = 0; i < pieces; ++i) {
+        const int type = randomizer.next();
+        counts[type]++;
+
+        if (i >= 1) pairs[prev1 * n + type]++;
+        if (i >= 2) triples[(prev2 * n + prev1) * n + type]++;
+
+        if (lastSeen[type] != 0) {
+            const quint64 gap = i - lastSeen[type];
+            histogram[type * (MAX_GAP + 1) + std::min<quint64>(gap, MAX_GAP)]++;
+            if (gap > maxGap[type]) maxGap[type] = gap;
+        }
+        lastSeen[type] = i + 1;
+
+        prev2 = prev1;
+        prev1 = type;
+    }
+
+    // 末尾尚未结束的干旱（从未出现的类型为整条流）
+    for (int t = 0; t < n; ++t) {
+        stats.maxOpenGap[t] = pieces - lastSeen[t];
+    }
+
+    stats.pieces = pieces;
+    stats.pairSamples = pieces > 1 ? pieces - 1 : 0;
+    stats.tripleSamples = pieces > 2 ? pieces - 2 : 0;
+}
+
+// 从直方图计算分位数
+int percentile(const quint64* histogram, quint64 total, double q)
+{
+    const quint64 target = static_cast<quint64>(q * total);
+    quint64 accumulated = 0;
+    for (int gap = 0; gap <= MAX_GAP; ++gap) {
+        accumulated += histogram[gap];
+        if (accumulated > target) return gap;
+    }
+    return MAX_GAP;
+}
+
+QString typeName(int type, int typeCount)
+{
+    static const char* STANDARD_NAMES[] = { "I", "O", "T", "S", "Z", "J", "L" };
+    if (typeCount == Block::TYPE_COUNT) return STANDARD_NAMES[type];
+    return QString("#%1").arg(type);
+}
+
+void printReport(QTextStream& out, const StreamStats& stats)
+{
+    const int n = stats.typeCount;
+
+    // 分布
+    out << "\n[类型分布]\n";
+    const double expected = 1.0 / n;
+    for (int t = 0; t < n; ++t) {
+        double freq = static_cast<double>(stats.counts[t]) / stats.pieces;
+        out << QString("  %1  %2  %3%  偏差 %4%\n")
+                   .arg(typeName(t, n), 4)
+                   .arg(stats.counts[t], 14)
+                   .arg(freq * 100.0, 8, 'f', 4)
+                   .arg((freq - expected) / expected * 100.0, 8, 'f', 4);
+    }
+
+    // 干旱
+    out << "\n[间隔统计]（两次出现之间的方块数）\n";
+    for (int t = 0; t < n; ++t) {
+        const quint64* histogram = stats.gapHistogram.data() + t * (MAX_GAP + 1);
+        quint64 total = 0;
+        double sum = 0.0;
+        for (int gap = 0; gap <= MAX_GAP; ++gap) {
+            total += histogram[gap];
+            sum += static_cast<double>(histogram[gap]) * gap;
+        }
+        if (total == 0) continue;
+
+        out << QString("  %1  平均 %2  p50 %3  p99 %4  p99.99 %5  最长 %6  末尾干旱 %7\n")
+                   .arg(typeName(t, n), 4)
+                   .arg(sum / total, 7, 'f', 3)
+                   .arg(percentile(histogram, total, 0.5), 4)
+                   .arg(percentile(histogram, total, 0.99), 4)
+                   .arg(percentile(histogram, total, 0.9999), 4)
+                   .arg(stats.maxGap[t])
+                   .arg(stats.maxOpenGap[t]);
+    }
+
+    // I方块干旱直方图
+    const int droughtType = Block::TYPE_I < n ? Block::TYPE_I : 0;
+    const quint64* drought = stats.gapHistogram.data() + droughtType * (MAX_GAP + 1);
+    quint64 droughtTotal = 0;
+    for (int gap = 0; gap <= MAX_GAP; ++gap) droughtTotal += drought[gap];
+    out << QString("\n[%1 方块干旱分布]\n").arg(typeName(droughtType, n));
+    int lastGap = static_cast<int>(std::min<quint64>(stats.maxGap[droughtType], 40));
+    for (int gap = 0; gap <= lastGap; ++gap) {
+        if (drought[gap] == 0 || droughtTotal == 0) continue;
+        out << QString("  %1  %2  %3%\n")
+                   .arg(gap, 4)
+                   .arg(drought[gap], 14)
+                   .arg(100.0 * drought[gap] / droughtTotal, 9, 'f', 5);
+    }
+
+    // 配对频率（相对于完全随机的期望值）
+    out << "\n[配对频率]（行: 前一个, 列: 后一个, 1.000 = 完全随机期望，只统计流内相邻的方块）\n      ";
+    for (int t = 0; t < n; ++t) out << QString("%1").arg(typeName(t, n), 7);
+    out << "\n";
+    const double pairTotal = static_cast<double>(stats.pairSamples);
+    for (int a = 0; a < n; ++a) {
+        out << QString("  %1").arg(typeName(a, n), 4);
+        for (int b = 0; b < n; ++b) {
+            double ratio = stats.pairs[a * n + b] / pairTotal * n * n;
+            out << QString("%1").arg(ratio, 7, 'f', 3);
+        }
+        out << "\n";
+    }
+
+    // 三连序列
+    std::vector<int> order(stats.triples.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = static_cast<int>(i);
+    std::sort(order.begin(), order.end(), [&stats](int a, int b) {
+        return stats.triples[a] > stats.triples[b];
+    });
+
+    const double tripleExpected = static_cast<double>(stats.tripleSamples) / (n * n * n);
+    auto printTriple = [&](int index) {
+        out << QString("  %1%2%3  %4  %5\n")
+                   .arg(typeName(index / (n * n), n))
+                   .arg(typeName(index / n % n, n))
+                   .arg(typeName(index % n, n))
+                   .arg(stats.triples[index], 14)
+                   .arg(stats.triples[index] / tripleExpected, 7, 'f', 3);
+    };
+
+    const int shown = std::min<int>(5, static_cast<int>(order.size()));
+    out << "\n[三连序列] 最常见\n";
+    for (int i = 0; i < shown; ++i) printTriple(order[i]);
+    out << "[三连序列] 最少见\n";
+    for (int i = static_cast<int>(order.size()) - shown; i < static_cast<int>(order.size()); ++i) printTriple(order[i]);
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("RandomizerAnalysis");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("方块随机化算法统计工具");
+    parser.addHelpOption();
+    QCommandLineOption piecesOption("pieces", "生成的方块总数", "count", "1000000000");
+    QCommandLineOption threadsOption("threads", "线程数（默认使用全部核心）", "count", "0");
+    QCommandLineOption modeOption("mode", "随机模式: 7-bag 或 random", "mode", "7-bag");
+    QCommandLineOption typesOption("types", "方块类型数", "count", QString::number(Block::TYPE_COUNT));
+    QCommandLineOption seedOption("seed", "初始种子（默认随机）", "seed");
+    parser.addOption(piecesOption);
+    parser.addOption(threadsOption);
+    parser.addOption(modeOption);
+    parser.addOption(typesOption);
+    parser.addOption(seedOption);
+    parser.process(app);
+
+    QTextStream out(stdout);
+
+    const quint64 totalPieces = parser.value(piecesOption).toULongLong();
+    int threadCount = parser.value(threadsOption).toInt();
+    if (threadCount <= 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    const int typeCount = qBound(2, parser.value(typesOption).toInt(), Randomizer::MAX_TYPES);
+    Randomizer::Mode mode = Randomizer::MODE_7BAG;
+    if (!Randomizer::parseMode(parser.value(modeOption).toStdString(), mode)) {
+        out << QString("未知的随机模式: %1（可选 7-bag 或 random）\n").arg(parser.value(modeOption));
+        return 1;
+    }
+    const quint64 seed = parser.isSet(seedOption) ? parser.value(seedOption).toULongLong()
+                                                  : BlockFactory::generateSeed();
+
+    if (totalPieces < 3) {
+        out << "方块总数至少为3\n";
+        return 1;
+    }
+
+    out << QString("随机模式: %1  类型数: %2  线程: %3  方块总数: %4  种子: %5\n")
+               .arg(mode == Randomizer::MODE_7BAG ? "7-bag" : "random")
+               .arg(typeCount)
+               .arg(threadCount)
+               .arg(totalPieces)
+               .arg(seed);
+    out.flush();
+
+    // 每个线程使用同一种子跳转得到的独立随机流，统计结果线程独占；
+    // 各流的配对样本数为流长度-1，合并时逐流累加
+    std::vector<StreamStats> results(threadCount, StreamStats(typeCount));
+    std::vector<std::thread> workers;
+    workers.reserve(threadCount);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    Randomizer randomizer(typeCount, mode);
+    randomizer.setSeed(seed);
+    for (int t = 0; t < threadCount; ++t) {
+        quint64 pieces = totalPieces / threadCount + (t < static_cast<int>(totalPieces % threadCount) ? 1 : 0);
+        workers.emplace_back(runStream, randomizer, pieces, std::ref(results[t]));
+        randomizer.jump();
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    const qint64 elapsed = timer.nsecsElapsed();
+
+    // 合并各线程的统计结果
+    StreamStats merged(typeCount);
+    for (const StreamStats& result : results) {
+        merged.merge(result);
+    }
+
+    out << QString("耗时: %1 s  吞吐: %2 M/s\n")
+               .arg(elapsed / 1e9, 0, 'f', 3)
+               .arg(totalPieces / (elapsed / 1e3), 0, 'f', 1);
+
+    printReport(out, merged);
+    return 0;
+}
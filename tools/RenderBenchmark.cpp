@@ -0,0 +1,258 @@
+// 场地绘制性能测试
+// 在 offscreen 平台上比较三种绘制方式在不同格子大小下的单帧耗时：
+//   1. 原先的 QPainter 逐格绘制（每格 fillRect + 多次 drawLine/drawRect，开启抗锯齿）
+//   2. QPainter 贴图（每格 drawImage 一次，从图集子区域取贴图）
+//   3. FieldRasterizer 直接写入扫描线，再整帧贴图一次
+// 场地格子带方块种类，贴图与游戏中一样从当前主题的图集中取
+#include <QGuiApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <QPainter>
+#include <QImage>
+#include "GameField.h"
+#include "PieceSet.h"
+#include "Block.h"
+#include "RandomGenerator.h"
+#include "CellSpriteCache.h"
+#include "FieldRasterizer.h"
+#include "Theme.h"
+
+namespace {
+
+constexpr int FIELD_W = 10;
+constexpr int FIELD_H = 20;
+
+// 测试场景：下方约四分之三的行随机填充，当前方块在顶部左右移动
+struct Scene {
+    GameField field;
+    Block current;
+    Block ghost;
+
+    Scene() : field(FIELD_W, FIELD_H) {}
+};
+
+void buildScene(Scene& scene, quint64 seed)
+{
+    const PieceSet* pieceSet = PieceSet::standard();
+    RandomGenerator rng(seed);
+
+    for (int y = FIELD_H / 4; y < FIELD_H; ++y) {
+        for (int x = 0; x < FIELD_W; ++x) {
+            if (rng.bounded(100) < 70) {
+                const int type = static_cast<int>(rng.bounded(pieceSet->getPieceCount()));
+                scene.field.setCell(x, y, pieceSet->getPiece(type).color, type);
+            }
+        }
+    }
+
+    scene.current = Block(Block::TYPE_T, &pieceSet->getPiece(Block::TYPE_T));
+    scene.current.setPosition(3, 0);
+    scene.ghost = scene.current;
+    scene.ghost.setPosition(3, FIELD_H / 4 - 2);
+}
+
+// 每帧左右移动方块，并改动一个格子，模拟正常游戏中的场地变化
+void advanceScene(Scene& scene, int frame)
+{
+    const int x = 1 + frame % (FIELD_W - 3);
+    scene.current.setPosition(x, 0);
+    scene.ghost.setPosition(x, FIELD_H / 4 - 2);
+
+    const int cellX = frame % FIELD_W;
+    if (scene.field.isCellEmpty(cellX, FIELD_H - 1)) {
+        scene.field.setCell(cellX, FIELD_H - 1, PieceSet::standard()->getPiece(Block::TYPE_I).color, Block::TYPE_I);
+    } else {
+        scene.field.clearCell(cellX, FIELD_H - 1);
+    }
+}
+
+// 1. 原先的逐格绘制
+void paintLegacy(QPainter& painter, const Scene& scene, int cellSize)
+{
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.fillRect(0, 0, FIELD_W * cellSize, FIELD_H * cellSize, QColor(20, 20, 20));
+
+    painter.setPen(QPen(QColor(40, 40, 40), 1));
+    for (int x = 0; x <= FIELD_W; ++x) {
+        painter.drawLine(x * cellSize, 0, x * cellSize, FIELD_H * cellSize);
+    }
+    for (int y = 0; y <= FIELD_H; ++y) {
+        painter.drawLine(0, y * cellSize, FIELD_W * cellSize, y * cellSize);
+    }
+
+    for (int y = 0; y < FIELD_H; ++y) {
+        for (int x = 0; x < FIELD_W; ++x) {
+            if (scene.field.isCellEmpty(x, y)) continue;
+
+            painter.fillRect(x * cellSize, y * cellSize, cellSize, cellSize, scene.field.getCellColor(x, y));
+            painter.setPen(QPen(QColor(255, 255, 255, 150), 2));
+            painter.drawLine(x * cellSize, y * cellSize, (x + 1) * cellSize, y * cellSize);
+            painter.drawLine(x * cellSize, y * cellSize, x * cellSize, (y + 1) * cellSize);
+            painter.setPen(QPen(QColor(0, 0, 0, 100), 2));
+            painter.drawLine((x + 1) * cellSize, y * cellSize, (x + 1) * cellSize, (y + 1) * cellSize);
+            painter.drawLine(x * cellSize, (y + 1) * cellSize, (x + 1) * cellSize, (y + 1) * cellSize);
+            painter.setPen(QPen(QColor(255, 255, 255, 50), 1));
+            painter.drawRect(x * cellSize + 2, y * cellSize + 2, cellSize - 4, cellSize - 4);
+        }
+    }
+
+    QColor ghostColor = scene.ghost.getColor();
+    ghostColor.setAlpha(80);
+    for (const Position& cell : scene.ghost.getOccupiedCells()) {
+        painter.fillRect(cell.x * cellSize, cell.y * cellSize, cellSize, cellSize, ghostColor);
+    }
+
+    painter.setBrush(scene.current.getColor());
+    painter.setPen(QPen(Qt::white, 2));
+    for (const Position& cell : scene.current.getOccupiedCells()) {
+        const int x = cell.x * cellSize;
+        const int y = cell.y * cellSize;
+        painter.drawRect(x, y, cellSize, cellSize);
+        painter.setPen(QPen(QColor(255, 255, 255, 200), 2));
+        painter.drawLine(x, y, x + cellSize, y);
+        painter.drawLine(x, y, x, y + cellSize);
+        painter.setPen(QPen(QColor(0, 0, 0, 100), 2));
+        painter.drawLine(x + cellSize, y, x + cellSize, y + cellSize);
+        painter.drawLine(x, y + cellSize, x + cellSize, y + cellSize);
+    }
+}
+
+// 2. QPainter 逐格贴图
+void paintSprites(QPainter& painter, const Scene& scene, CellSpriteCache& sprites, int cellSize)
+{
+    painter.fillRect(0, 0, FIELD_W * cellSize, FIELD_H * cellSize, QColor(20, 20, 20));
+
+    painter.setPen(QPen(QColor(40, 40, 40), 1));
+    for (int x = 0; x <= FIELD_W; ++x) {
+        painter.drawLine(x * cellSize, 0, x * cellSize, FIELD_H * cellSize);
+    }
+    for (int y = 0; y <= FIELD_H; ++y) {
+        painter.drawLine(0, y * cellSize, FIELD_W * cellSize, y * cellSize);
+    }
+
+    for (int y = 0; y < FIELD_H; ++y) {
+        for (int x = 0; x < FIELD_W; ++x) {
+            if (scene.field.isCellEmpty(x, y)) continue;
+            const CellSpriteCache::Sprite cell = sprites.sprite(scene.field.getCellType(x, y), scene.field.getCellColor(x, y),
+                                                                CellSpriteCache::STYLE_LOCKED);
+            painter.drawImage(QPoint(x * cellSize, y * cellSize), *cell.image, cell.rect);
+        }
+    }
+
+    const CellSpriteCache::Sprite ghost = sprites.sprite(scene.ghost.getType(), scene.ghost.getColor(), CellSpriteCache::STYLE_GHOST);
+    for (const Position& cell : scene.ghost.getOccupiedCells()) {
+        painter.drawImage(QPoint(cell.x * cellSize, cell.y * cellSize), *ghost.image, ghost.rect);
+    }
+
+    const CellSpriteCache::Sprite active = sprites.sprite(scene.current.getType(), scene.current.getColor(), CellSpriteCache::STYLE_ACTIVE);
+    for (const Position& cell : scene.current.getOccupiedCells()) {
+        painter.drawImage(QPoint(cell.x * cellSize, cell.y * cellSize), *active.image, active.rect);
+    }
+}
+
+// 运行一种绘制方式，返回单帧平均耗时（微秒）
+template <typename PaintFunc>
+double measure(int frames, int cellSize, PaintFunc paint)
+{
+    Scene scene;
+    buildScene(scene, 20240101);
+
+    // 目标与窗口后备缓冲区格式相同
+    QImage target(FIELD_W * cellSize, FIELD_H * cellSize, QImage::Format_ARGB32_Premultiplied);
+
+    // 预热（建立贴图缓存等）
+    for (int i = 0; i < 10; ++i) {
+        QPainter painter(&target);
+        paint(painter, scene);
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < frames; ++i) {
+        advanceScene(scene, i);
+        QPainter painter(&target);
+        paint(painter, scene);
+    }
+    return timer.nsecsElapsed() / 1000.0 / frames;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    // 默认使用 offscreen 平台，无需显示器
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
+    QGuiApplication app(argc, argv);
+    QCoreApplication::setApplicationName("RenderBenchmark");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("场地绘制性能测试");
+    parser.addHelpOption();
+    QCommandLineOption framesOption("frames", "每项测试的帧数", "count", "2000");
+    QCommandLineOption sizesOption("sizes", "格子大小列表（逗号分隔）", "list", "16,30,48,64");
+    QCommandLineOption themeOption("theme", "主题（default、内置主题或主题数据文件路径）", "theme", "default");
+    parser.addOption(framesOption);
+    parser.addOption(sizesOption);
+    parser.addOption(themeOption);
+    parser.process(app);
+
+    const int frames = qMax(1, parser.value(framesOption).toInt());
+
+    // 与渲染线程一样把主题交给贴图缓存和光栅化器
+    const Theme* theme = Theme::get(parser.value(themeOption));
+    if (!theme) {
+        QTextStream(stderr) << QString("无法加载主题: %1\n").arg(parser.value(themeOption));
+        return 1;
+    }
+
+    QTextStream out(stdout);
+    out << QString("平台: %1  场地: %2x%3  帧数: %4  主题: %5\n\n")
+               .arg(QGuiApplication::platformName())
+               .arg(FIELD_W)
+               .arg(FIELD_H)
+               .arg(frames)
+               .arg(theme->getName());
+    out << QString("%1%2%3%4%5\n")
+               .arg("格子", 6)
+               .arg("逐格绘制(us)", 16)
+               .arg("逐格贴图(us)", 16)
+               .arg("光栅化(us)", 14)
+               .arg("加速比", 10);
+
+    const QStringList sizes = parser.value(sizesOption).split(',', Qt::SkipEmptyParts);
+    for (const QString& sizeText : sizes) {
+        const int cellSize = sizeText.trimmed().toInt();
+        if (cellSize <= 0) continue;
+
+        const double legacy = measure(frames, cellSize, [cellSize](QPainter& painter, const Scene& scene) {
+            paintLegacy(painter, scene, cellSize);
+        });
+
+        CellSpriteCache sprites(cellSize);
+        sprites.setTheme(theme);
+        const double sprite = measure(frames, cellSize, [&sprites, cellSize](QPainter& painter, const Scene& scene) {
+            paintSprites(painter, scene, sprites, cellSize);
+        });
+
+        FieldRasterizer rasterizer;
+        rasterizer.setTheme(theme);
+        rasterizer.setGeometry(cellSize, 1.0);
+        const double raster = measure(frames, cellSize, [&rasterizer](QPainter& painter, const Scene& scene) {
+            painter.drawImage(0, 0, rasterizer.render(scene.field, &scene.current, 0.0f, &scene.ghost));
+        });
+
+        out << QString("%1%2%3%4%5x\n")
+                   .arg(cellSize, 6)
+                   .arg(legacy, 16, 'f', 1)
+                   .arg(sprite, 16, 'f', 1)
+                   .arg(raster, 14, 'f', 1)
+                   .arg(legacy / raster, 9, 'f', 1);
+        out.flush();
+    }
+
+    return 0;
+}
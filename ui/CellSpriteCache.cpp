@@ -0,0 +1,203 @@
+#include <QPainter>
+#include <QDebug>
+#include "CellSpriteCache.h"
+#include "GameConfig.h"
+
+static_assert(CellSpriteCache::STYLE_COUNT == Theme::MAX_STYLES, "Theme atlas rows must match sprite styles");
+
+CellSpriteCache::CellSpriteCache(int cellSize)
+    : m_cellSize(cellSize)
+    , m_theme(Theme::defaultTheme())
+    , m_pieceSet(PieceSet::get(QString::fromStdString(PIECE_SET)))
+    , m_atlasColumns(0)
+{
+    if (!m_pieceSet) {
+        m_pieceSet = PieceSet::standard();
+    }
+}
+
+void CellSpriteCache::setCellSize(int cellSize)
+{
+    if (cellSize == m_cellSize) return;
+
+    m_cellSize = cellSize;
+    invalidate();
+}
+
+void CellSpriteCache::setTheme(const Theme* theme)
+{
+    if (!theme || theme == m_theme) return;
+
+    m_theme = theme;
+    invalidate();
+}
+
+void CellSpriteCache::invalidate()
+{
+    // 旧图集直接释放，同一时刻只保留当前格子大小的一张图集
+    m_atlas = QImage();
+    m_atlasOpaque.clear();
+    m_atlasColumns = 0;
+    m_sprites.clear();
+}
+
+CellSpriteCache::Sprite CellSpriteCache::sprite(int type, const QColor& color, Style style)
+{
+    if (m_atlas.isNull() && m_cellSize > 0) {
+        buildAtlas();
+    }
+
+    if (type >= 0 && type < m_atlasColumns) {
+        const int cell = m_cellSize;
+        return Sprite{ &m_atlas, QRect(type * cell, style * cell, cell, cell), m_atlasOpaque[style * m_atlasColumns + type] };
+    }
+
+    const QImage& image = sprite(color, style);
+    return Sprite{ &image, image.rect(), style != STYLE_GHOST && color.alpha() == 255 };
+}
+
+const QImage& CellSpriteCache::sprite(const QColor& color, Style style)
+{
+    const quint64 key = (static_cast<quint64>(color.rgba()) << 8) | style;
+
+    auto it = m_sprites.find(key);
+    if (it == m_sprites.end()) {
+        it = m_sprites.insert(key, renderSprite(color, style));
+    }
+    return it.value();
+}
+
+void CellSpriteCache::buildAtlas()
+{
+    const int cell = m_cellSize;
+    const int columns = m_pieceSet->getPieceCount();
+
+    m_atlas = QImage(columns * cell, STYLE_COUNT * cell, QImage::Format_ARGB32_Premultiplied);
+    m_atlas.fill(Qt::transparent);
+
+    {
+        QPainter painter(&m_atlas);
+        painter.setRenderHint(QPainter::SmoothPixmapTransform);
+
+        for (int style = 0; style < STYLE_COUNT; ++style) {
+            for (int type = 0; type < columns; ++type) {
+                const PieceSet::Piece& piece = m_pieceSet->getPiece(type);
+                const QRect target(type * cell, style * cell, cell, cell);
+                const QRect source = m_theme->tileRect(style, piece.name);
+
+                if (!source.isNull()) {
+                    // 主题图集只在这里缩放到当前格子大小
+                    painter.drawImage(target, m_theme->getAtlas(), source);
+                } else {
+                    // 主题没有提供的贴图按方块颜色绘制，裁剪到自己的区域内
+                    painter.save();
+                    painter.setClipRect(target);
+                    painter.translate(target.topLeft());
+                    paintSprite(painter, cell, piece.color, static_cast<Style>(style));
+                    painter.restore();
+                }
+            }
+        }
+    }
+
+    // 预先判断每块贴图是否不透明，绘制时不透明贴图整行复制
+    m_atlasColumns = columns;
+    m_atlasOpaque.resize(STYLE_COUNT * columns);
+    for (int style = 0; style < STYLE_COUNT; ++style) {
+        for (int type = 0; type < columns; ++type) {
+            m_atlasOpaque[style * columns + type] = isOpaque(m_atlas, QRect(type * cell, style * cell, cell, cell));
+        }
+    }
+}
+
+QImage CellSpriteCache::renderSprite(const QColor& color, Style style) const
+{
+    QImage image(m_cellSize, m_cellSize, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+
+    QPainter painter(&image);
+    paintSprite(painter, m_cellSize, color, style);
+    painter.end();
+
+    return image;
+}
+
+void CellSpriteCache::paintSprite(QPainter& painter, int size, const QColor& color, Style style)
+{
+    switch (style) {
+    case STYLE_LOCKED:
+        // 绘制方块主体
+        painter.fillRect(0, 0, size, size, color);
+
+        // 绘制高光效果
+        painter.setPen(QPen(QColor(255, 255, 255, 150), 2));
+        painter.drawLine(0, 0, size, 0);
+        painter.drawLine(0, 0, 0, size);
+
+        // 绘制阴影效果
+        painter.setPen(QPen(QColor(0, 0, 0, 100), 2));
+        painter.drawLine(size, 0, size, size);
+        painter.drawLine(0, size, size, size);
+
+        // 绘制内部细节
+        painter.setPen(QPen(QColor(255, 255, 255, 50), 1));
+        painter.drawRect(2, 2, size - 4, size - 4);
+        break;
+
+    case STYLE_ACTIVE:
+        // 绘制方块主体和白色边框
+        painter.fillRect(0, 0, size, size, color);
+        painter.setPen(QPen(Qt::white, 2));
+        painter.drawRect(0, 0, size, size);
+
+        // 绘制高光效果
+        painter.setPen(QPen(QColor(255, 255, 255, 200), 2));
+        painter.drawLine(0, 0, size, 0);
+        painter.drawLine(0, 0, 0, size);
+
+        // 绘制阴影效果
+        painter.setPen(QPen(QColor(0, 0, 0, 100), 2));
+        painter.drawLine(size, 0, size, size);
+        painter.drawLine(0, size, size, size);
+        break;
+
+    case STYLE_PREVIEW:
+        // 预览窗格：白色细边框和简单的立体效果
+        painter.fillRect(0, 0, size, size, color);
+        painter.setPen(QPen(Qt::white, 1));
+        painter.drawRect(0, 0, size - 1, size - 1);
+
+        painter.setPen(QPen(QColor(255, 255, 255, 150), 1));
+        painter.drawLine(0, 0, size - 1, 0);
+        painter.drawLine(0, 0, 0, size - 1);
+
+        painter.setPen(QPen(QColor(0, 0, 0, 100), 1));
+        painter.drawLine(size - 1, 0, size - 1, size - 1);
+        painter.drawLine(0, size - 1, size - 1, size - 1);
+        break;
+
+    case STYLE_GHOST: {
+        // 半透明虚影
+        QColor ghostColor = color;
+        ghostColor.setAlpha(80);
+        painter.fillRect(0, 0, size, size, ghostColor);
+        break;
+    }
+
+    default:
+        break;
+    }
+}
+
+bool CellSpriteCache::isOpaque(const QImage& image, const QRect& rect)
+{
+    for (int y = rect.top(); y <= rect.bottom(); ++y) {
+        const QRgb* line = reinterpret_cast<const QRgb*>(image.constScanLine(y));
+        for (int x = rect.left(); x <= rect.right(); ++x) {
+            if (qAlpha(line[x]) != 255) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
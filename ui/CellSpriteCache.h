@@ -0,0 +1,69 @@
+#ifndef CELLSPRITECACHE_H
+#define CELLSPRITECACHE_H
+#include <QHash>
+#include <QVector>
+#include <QImage>
+#include <QColor>
+#include "PieceSet.h"
+#include "Theme.h"
+
+// 格子贴图缓存
+// 当前主题下所有方块种类、所有样式的贴图按当前格子大小打包到一张图集中，
+// 主题或格子大小变化后首次使用时生成一次（主题图集在这里缩放一次），绘制时只从子区域贴图；
+// 没有种类的格子按颜色单独渲染并缓存
+class CellSpriteCache
+{
+public:
+    // 贴图样式（图集中的行）
+    enum Style {
+        STYLE_LOCKED,   // 已放置的方块
+        STYLE_ACTIVE,   // 当前下落的方块
+        STYLE_GHOST,    // 幽灵方块
+        STYLE_PREVIEW,  // 预览窗格中的方块
+        STYLE_COUNT
+    };
+
+    // 图集（或单独贴图）中的一块区域
+    struct Sprite {
+        const QImage* image;
+        QRect rect;
+        bool opaque;    // 所有像素均不透明，可整行复制
+    };
+
+    explicit CellSpriteCache(int cellSize = 0);
+
+    // 格子大小变化时清空缓存
+    void setCellSize(int cellSize);
+    int getCellSize() const { return m_cellSize; }
+
+    // 主题变化时清空缓存
+    void setTheme(const Theme* theme);
+    const Theme* getTheme() const { return m_theme; }
+
+    // 清空缓存，下次使用时重建图集
+    void invalidate();
+
+    // 按方块种类从图集获取贴图，种类无效时退回按颜色渲染的单独贴图
+    Sprite sprite(int type, const QColor& color, Style style);
+
+    // 按颜色获取单独贴图（不存在时渲染并缓存）
+    const QImage& sprite(const QColor& color, Style style);
+
+private:
+    void buildAtlas();
+    QImage renderSprite(const QColor& color, Style style) const;
+    static void paintSprite(QPainter& painter, int size, const QColor& color, Style style);  // 程序化绘制（默认主题）
+    static bool isOpaque(const QImage& image, const QRect& rect);
+
+    int m_cellSize;
+    const Theme* m_theme;
+    const PieceSet* m_pieceSet;         // 图集的列与方块集合中的种类一一对应
+
+    QImage m_atlas;                     // 当前格子大小的图集，行为样式，列为方块种类
+    QVector<bool> m_atlasOpaque;        // 图集中每块贴图是否不透明（样式 * 列数 + 种类）
+    int m_atlasColumns;
+
+    QHash<quint64, QImage> m_sprites;   // 单独贴图，键为颜色和样式的组合
+};
+
+#endif // CELLSPRITECACHE_H
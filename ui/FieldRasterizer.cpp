@@ -0,0 +1,330 @@
+#include <QPainter>
+#include <cstring>
+#include "FieldRasterizer.h"
+#include "ParticleSystem.h"
+
+namespace {
+
+// 预乘像素的各通道乘以 alpha/255（与 Qt 内部的 BYTE_MUL 相同）
+inline quint32 byteMul(quint32 x, quint32 a)
+{
+    quint32 t = (x & 0xff00ff) * a;
+    t = (t + ((t >> 8) & 0xff00ff) + 0x800080) >> 8;
+    t &= 0xff00ff;
+
+    x = ((x >> 8) & 0xff00ff) * a;
+    x = (x + ((x >> 8) & 0xff00ff) + 0x800080);
+    x &= 0xff00ff00;
+    return x | t;
+}
+
+// 半透明行混合（SourceOver），循环体无分支依赖，编译器可自动向量化
+inline void blendRow(quint32* dst, const quint32* src, int count)
+{
+    for (int i = 0; i < count; ++i) {
+        const quint32 s = src[i];
+        dst[i] = s + byteMul(dst[i], 255 - (s >> 24));
+    }
+}
+
+// 纯色行混合（SourceOver）
+inline void fillRow(quint32* dst, quint32 color, int count)
+{
+    const quint32 inverseAlpha = 255 - (color >> 24);
+    for (int i = 0; i < count; ++i) {
+        dst[i] = color + byteMul(dst[i], inverseAlpha);
+    }
+}
+
+} // namespace
+
+FieldRasterizer::FieldRasterizer()
+    : m_cellSize(0)
+    , m_devicePixelRatio(1.0)
+    , m_deviceCellSize(0)
+    , m_layerGeneration(0)
+    , m_dirtyTop(0)
+    , m_dirtyBottom(0)
+{
+}
+
+void FieldRasterizer::setGeometry(int cellSize, qreal devicePixelRatio)
+{
+    if (cellSize == m_cellSize && qFuzzyCompare(devicePixelRatio, m_devicePixelRatio)) return;
+
+    m_cellSize = cellSize;
+    m_devicePixelRatio = devicePixelRatio;
+    m_deviceCellSize = qMax(1, qRound(cellSize * devicePixelRatio));
+    m_spriteCache.setCellSize(m_deviceCellSize);
+
+    // 下次合成时按新尺寸重建
+    m_fieldSize = QSize();
+}
+
+void FieldRasterizer::setTheme(const Theme* theme)
+{
+    if (!theme || theme == m_spriteCache.getTheme()) return;
+
+    m_spriteCache.setTheme(theme);
+    m_fieldSize = QSize();
+}
+
+void FieldRasterizer::invalidate()
+{
+    m_spriteCache.invalidate();
+    m_fieldSize = QSize();
+}
+
+void FieldRasterizer::rebuild(const GameField& field)
+{
+    const int cell = m_deviceCellSize;
+    m_fieldSize = field.getBounds().size();
+    const QSize imageSize(m_fieldSize.width() * cell, m_fieldSize.height() * cell);
+
+    // 背景和网格只在这里用 QPainter 绘制一次
+    m_background = QImage(imageSize, QImage::Format_ARGB32_Premultiplied);
+    const Theme* theme = m_spriteCache.getTheme();
+    m_background.fill(theme->getBackgroundColor());
+    {
+        QPainter painter(&m_background);
+        painter.setPen(QPen(theme->getGridColor(), qMax(1, qRound(m_devicePixelRatio))));
+        for (int x = 0; x <= m_fieldSize.width(); ++x) {
+            painter.drawLine(x * cell, 0, x * cell, imageSize.height());
+        }
+        for (int y = 0; y <= m_fieldSize.height(); ++y) {
+            painter.drawLine(0, y * cell, imageSize.width(), y * cell);
+        }
+    }
+
+    // 图层和帧从背景复制，随后按行同步场地
+    m_layer = m_background.copy();
+    m_frame = m_background.copy();
+    m_frame.setDevicePixelRatio(m_devicePixelRatio);
+
+    // 代数从1开始分配，0不会与任何场地代数相同
+    m_layerRowGenerations.fill(0, m_fieldSize.height());
+    m_layerGeneration = 0;
+    m_dirtyTop = 0;
+    m_dirtyBottom = 0;
+}
+
+const QImage& FieldRasterizer::render(const GameField& field, const Block* current, float fallOffset, const Block* ghost)
+{
+    if (m_deviceCellSize <= 0) return m_frame;
+
+    if (m_fieldSize != field.getBounds().size()) {
+        rebuild(field);
+    }
+
+    // 同步图层中变化的行，这些行也需要复制到帧
+    if (field.getGeneration() != m_layerGeneration) {
+        for (int y = 0; y < m_fieldSize.height(); ++y) {
+            if (field.getRowGeneration(y) == m_layerRowGenerations[y]) continue;
+
+            updateLayerRow(field, y);
+            m_layerRowGenerations[y] = field.getRowGeneration(y);
+            markDirty(y * m_deviceCellSize, (y + 1) * m_deviceCellSize);
+        }
+        m_layerGeneration = field.getGeneration();
+    }
+
+    // 擦除上一帧的方块
+    restoreRows(m_dirtyTop, m_dirtyBottom);
+    m_dirtyTop = m_dirtyBottom = 0;
+
+    if (ghost && ghost->isValid()) {
+        drawBlock(*ghost, 0, CellSpriteCache::STYLE_GHOST);
+    }
+    if (current && current->isValid()) {
+        drawBlock(*current, qRound(fallOffset * m_deviceCellSize), CellSpriteCache::STYLE_ACTIVE);
+    }
+
+    return m_frame;
+}
+
+void FieldRasterizer::drawLineClear(const LineClearEvent& event, float flash, float collapse)
+{
+    if (m_frame.isNull() || event.width != m_fieldSize.width()) return;
+
+    const int cell = m_deviceCellSize;
+    const int rowWidth = event.width * cell;
+
+    for (int i = 0; i < event.rowCount; ++i) {
+        const int y = event.rows[i];
+        if (y < 0 || y >= m_fieldSize.height()) continue;
+
+        const int top = y * cell;
+
+        if (collapse <= 0.0f) {
+            // 闪烁阶段：先画出被消除的格子，再叠加白色
+            for (int x = 0; x < event.width; ++x) {
+                const QRgb rgba = event.cells[i][x];
+                if (qAlpha(rgba) == 0) continue;
+
+                const CellSpriteCache::Sprite sprite = m_spriteCache.sprite(event.types[i][x], QColor::fromRgba(rgba), CellSpriteCache::STYLE_LOCKED);
+                blit(m_frame, x * cell, top, *sprite.image, sprite.rect, sprite.opaque);
+            }
+            fill(m_frame, QRect(0, top, rowWidth, cell), qPremultiply(qRgba(255, 255, 255, qRound(qBound(0.0f, flash, 1.0f) * 255))));
+        } else {
+            // 收缩阶段：白条向行的中线收缩并淡出
+            const float remaining = 1.0f - qBound(0.0f, collapse, 1.0f);
+            const int height = qMax(1, qRound(cell * remaining));
+            const int alpha = qRound(qBound(0.0f, flash, 1.0f) * remaining * 255);
+            fill(m_frame, QRect(0, top + (cell - height) / 2, rowWidth, height), qPremultiply(qRgba(255, 255, 255, alpha)));
+        }
+
+        // 下一帧从图层恢复这一行
+        markDirty(top, top + cell);
+    }
+}
+
+void FieldRasterizer::drawParticles(const ParticleSystem& particles)
+{
+    const int count = particles.getCount();
+    if (m_frame.isNull() || count == 0) return;
+
+    const float cell = static_cast<float>(m_deviceCellSize);
+    const int size = qMax(1, m_deviceCellSize / 8);
+    const int maxX = m_frame.width() - size;
+    const int maxY = m_frame.height() - size;
+    const int stride = m_frame.bytesPerLine();
+    uchar* bits = m_frame.bits();
+
+    const float* xs = particles.getX();
+    const float* ys = particles.getY();
+    const float* life = particles.getLife();
+    const float* inverseLifetime = particles.getInverseLifetime();
+    const quint32* colors = particles.getColor();
+
+    int top = m_frame.height();
+    int bottom = 0;
+
+    // 每个粒子是一个 size×size 的方块，颜色按剩余寿命预乘透明度后混合
+    for (int i = 0; i < count; ++i) {
+        const int px = static_cast<int>(xs[i] * cell);
+        const int py = static_cast<int>(ys[i] * cell);
+        if (px < 0 || py < 0 || px > maxX || py > maxY) continue;
+
+        const quint32 alpha = static_cast<quint32>(qBound(0.0f, life[i] * inverseLifetime[i], 1.0f) * 255.0f);
+        if (alpha == 0) continue;
+
+        const quint32 color = byteMul(colors[i], alpha);
+        for (int row = 0; row < size; ++row) {
+            fillRow(reinterpret_cast<quint32*>(bits + (py + row) * stride) + px, color, size);
+        }
+
+        top = qMin(top, py);
+        bottom = qMax(bottom, py + size);
+    }
+
+    // 下一帧从图层恢复粒子覆盖的行
+    if (top < bottom) {
+        markDirty(top, bottom);
+    }
+}
+
+void FieldRasterizer::updateLayerRow(const GameField& field, int y)
+{
+    const int cell = m_deviceCellSize;
+    const int bytesPerLine = m_layer.bytesPerLine();
+
+    // 先恢复背景，再写入已放置的方块
+    std::memcpy(m_layer.bits() + y * cell * bytesPerLine,
+                m_background.constBits() + y * cell * bytesPerLine,
+                static_cast<size_t>(bytesPerLine) * cell);
+
+    for (int x = 0; x < m_fieldSize.width(); ++x) {
+        if (field.isCellEmpty(x, y)) continue;
+
+        const CellSpriteCache::Sprite sprite = m_spriteCache.sprite(field.getCellType(x, y), field.getCellColor(x, y), CellSpriteCache::STYLE_LOCKED);
+        blit(m_layer, x * cell, y * cell, *sprite.image, sprite.rect, sprite.opaque);
+    }
+}
+
+void FieldRasterizer::restoreRows(int top, int bottom)
+{
+    top = qMax(top, 0);
+    bottom = qMin(bottom, m_frame.height());
+    if (top >= bottom) return;
+
+    // 帧和图层格式、宽度相同，连续的行一次复制
+    const int bytesPerLine = m_frame.bytesPerLine();
+    std::memcpy(m_frame.bits() + top * bytesPerLine,
+                m_layer.constBits() + top * bytesPerLine,
+                static_cast<size_t>(bytesPerLine) * (bottom - top));
+}
+
+void FieldRasterizer::markDirty(int top, int bottom)
+{
+    if (m_dirtyTop >= m_dirtyBottom) {
+        m_dirtyTop = top;
+        m_dirtyBottom = bottom;
+    } else {
+        m_dirtyTop = qMin(m_dirtyTop, top);
+        m_dirtyBottom = qMax(m_dirtyBottom, bottom);
+    }
+}
+
+void FieldRasterizer::drawBlock(const Block& block, int offsetY, CellSpriteCache::Style style)
+{
+    const int cell = m_deviceCellSize;
+    const CellSpriteCache::Sprite sprite = m_spriteCache.sprite(block.getType(), block.getColor(), style);
+
+    const PieceSet::Rotation& rotation = block.getRotationData();
+    const Position position = block.getPosition();
+
+    for (int i = 0; i < rotation.cellCount; ++i) {
+        const int x = (position.x + rotation.cells[i].x) * cell;
+        const int y = (position.y + rotation.cells[i].y) * cell + offsetY;
+        blit(m_frame, x, y, *sprite.image, sprite.rect, sprite.opaque);
+    }
+
+    // 下一帧需要从图层恢复这些行
+    const QRect& bounds = rotation.bounds;
+    markDirty((position.y + bounds.top()) * cell + offsetY, (position.y + bounds.bottom() + 1) * cell + offsetY);
+}
+
+void FieldRasterizer::blit(QImage& target, int x, int y, const QImage& sprite, bool opaque)
+{
+    blit(target, x, y, sprite, sprite.rect(), opaque);
+}
+
+void FieldRasterizer::blit(QImage& target, int x, int y, const QImage& atlas, const QRect& source, bool opaque)
+{
+    // 裁剪到目标图像范围
+    const int left = qMax(x, 0);
+    const int top = qMax(y, 0);
+    const int right = qMin(x + source.width(), target.width());
+    const int bottom = qMin(y + source.height(), target.height());
+    if (left >= right || top >= bottom) return;
+
+    const int count = right - left;
+    const int targetStride = target.bytesPerLine();
+    const int atlasStride = atlas.bytesPerLine();
+    uchar* targetBits = target.bits();
+    const uchar* atlasBits = atlas.constBits();
+
+    for (int row = top; row < bottom; ++row) {
+        quint32* dst = reinterpret_cast<quint32*>(targetBits + row * targetStride) + left;
+        const quint32* src = reinterpret_cast<const quint32*>(atlasBits + (source.top() + row - y) * atlasStride)
+                             + source.left() + (left - x);
+
+        if (opaque) {
+            std::memcpy(dst, src, count * sizeof(quint32));
+        } else {
+            blendRow(dst, src, count);
+        }
+    }
+}
+
+void FieldRasterizer::fill(QImage& target, const QRect& rect, quint32 premultipliedColor)
+{
+    const QRect clipped = rect.intersected(target.rect());
+    if (clipped.isEmpty() || (premultipliedColor >> 24) == 0) return;
+
+    const int stride = target.bytesPerLine();
+    uchar* bits = target.bits();
+    for (int row = clipped.top(); row <= clipped.bottom(); ++row) {
+        fillRow(reinterpret_cast<quint32*>(bits + row * stride) + clipped.left(), premultipliedColor, clipped.width());
+    }
+}
@@ -0,0 +1,74 @@
+#ifndef FIELDRASTERIZER_H
+#define FIELDRASTERIZER_H
+#include <QImage>
+#include <QVector>
+#include "CellSpriteCache.h"
+#include "GameField.h"
+#include "Block.h"
+#include "LineClearEvent.h"
+
+class ParticleSystem;
+
+// 游戏场地软件光栅化
+// 不经过 QPainter，直接按扫描线把格子贴图写入 ARGB32 图像：不透明贴图整行复制，
+// 半透明贴图逐像素混合。背景和已放置方块保存在图层中，只重建变化的行；
+// 每帧只从图层恢复上一帧被方块覆盖的行，再写入幽灵方块和当前方块
+class FieldRasterizer
+{
+public:
+    FieldRasterizer();
+
+    // 设置格子大小（逻辑像素）和设备像素比，图像按物理像素分配
+    void setGeometry(int cellSize, qreal devicePixelRatio);
+    int getDeviceCellSize() const { return m_deviceCellSize; }
+
+    // 切换主题（贴图图集和背景在下次合成时按新主题重建）
+    void setTheme(const Theme* theme);
+
+    // 清空贴图并重建所有图层
+    void invalidate();
+
+    // 合成一帧，current/ghost 为空时不绘制；fallOffset 为当前方块的下落偏移（格，可为小数）
+    const QImage& render(const GameField& field, const Block* current, float fallOffset, const Block* ghost);
+    const QImage& getFrame() const { return m_frame; }
+
+    // 在本帧上叠加消行效果：flash 为行变白的程度，collapse 为白条向中线收缩的程度（均为 0-1）
+    // 须在 render 之后调用，下一帧自动从图层恢复
+    void drawLineClear(const LineClearEvent& event, float flash, float collapse);
+
+    // 在本帧上一次性绘制所有粒子（按剩余寿命淡出），须在 render 之后调用
+    void drawParticles(const ParticleSystem& particles);
+
+    // 把贴图写入目标图像的 (x, y) 处，超出部分裁剪；两者均须为 ARGB32_Premultiplied
+    static void blit(QImage& target, int x, int y, const QImage& sprite, bool opaque);
+
+    // 把图集中 source 区域的贴图写入目标图像的 (x, y) 处
+    static void blit(QImage& target, int x, int y, const QImage& atlas, const QRect& source, bool opaque);
+
+    // 用预乘颜色混合填充目标图像的矩形区域，超出部分裁剪
+    static void fill(QImage& target, const QRect& rect, quint32 premultipliedColor);
+
+private:
+    void rebuild(const GameField& field);                   // 尺寸变化时重建背景、图层和帧
+    void updateLayerRow(const GameField& field, int y);     // 重建图层中的一行格子
+    void restoreRows(int top, int bottom);                  // 从图层复制像素行到帧
+    void markDirty(int top, int bottom);                    // 记录帧中需要恢复的像素行
+    void drawBlock(const Block& block, int offsetY, CellSpriteCache::Style style);
+
+    CellSpriteCache m_spriteCache;
+    int m_cellSize;                 // 格子大小（逻辑像素）
+    qreal m_devicePixelRatio;
+    int m_deviceCellSize;           // 格子大小（物理像素）
+
+    QSize m_fieldSize;              // 场地行列数
+    QImage m_background;            // 背景和网格
+    QImage m_layer;                 // 背景 + 已放置方块
+    QImage m_frame;                 // 最终画面
+    QVector<quint64> m_layerRowGenerations;  // 图层中每行对应的场地代数
+    quint64 m_layerGeneration;               // 图层对应的场地代数
+
+    int m_dirtyTop;                 // 帧中与图层不一致的像素行范围 [top, bottom)
+    int m_dirtyBottom;
+};
+
+#endif // FIELDRASTERIZER_H
@@ -0,0 +1,116 @@
+#include <QWidget>
+#include <QWindow>
+#include <QScreen>
+#include <QEvent>
+#include <QDebug>
+#include "FramePacer.h"
+
+FramePacer::FramePacer(QWidget* target)
+    : QObject(target)
+    , m_target(target)
+    , m_refreshRate(60.0)
+    , m_frameIntervalNs(1000000000LL / 60)
+    , m_lastFrameNs(-1)
+    , m_requestNs(0)
+    , m_pending(false)
+{
+    m_clock.start();
+
+    m_deferTimer.setSingleShot(true);
+    m_deferTimer.setTimerType(Qt::PreciseTimer);
+    connect(&m_deferTimer, &QTimer::timeout, this, &FramePacer::present);
+}
+
+FramePacer::~FramePacer()
+{
+    if (m_stats.presented > 0) {
+        qDebug() << "FramePacer: refresh" << m_refreshRate << "Hz, requested" << m_stats.requested
+                 << ", presented" << m_stats.presented << ", dropped" << m_stats.dropped;
+    }
+}
+
+void FramePacer::requestFrame()
+{
+    m_stats.requested++;
+
+    // 已有待绘制的帧，本次请求合并进去
+    if (m_pending) return;
+
+    m_pending = true;
+    m_requestNs = m_clock.nsecsElapsed();
+
+    attachWindow();
+    if (m_window) {
+        m_window->requestUpdate();
+    } else {
+        // 控件尚未显示，没有原生窗口时按刷新周期计时
+        m_deferTimer.start(static_cast<int>(m_frameIntervalNs / 1000000));
+    }
+}
+
+bool FramePacer::eventFilter(QObject* watched, QEvent* event)
+{
+    if (watched == m_window && event->type() == QEvent::UpdateRequest && m_pending && !m_deferTimer.isActive()) {
+        // 距上一帧不足一个刷新周期时延后，保证每个刷新周期最多渲染一次
+        const qint64 sinceLast = m_clock.nsecsElapsed() - m_lastFrameNs;
+        if (m_lastFrameNs >= 0 && sinceLast < m_frameIntervalNs) {
+            m_deferTimer.start(static_cast<int>((m_frameIntervalNs - sinceLast + 999999) / 1000000));
+        } else {
+            present();
+        }
+    }
+
+    // 不拦截事件，窗口自身的更新照常处理
+    return false;
+}
+
+void FramePacer::attachWindow()
+{
+    QWindow* window = m_target->window()->windowHandle();
+    if (window == m_window) return;
+
+    if (m_window) {
+        m_window->removeEventFilter(this);
+        disconnect(m_window, nullptr, this, nullptr);
+    }
+
+    m_window = window;
+    if (m_window) {
+        m_window->installEventFilter(this);
+        connect(m_window, &QWindow::screenChanged, this, &FramePacer::updateRefreshRate);
+        updateRefreshRate();
+    }
+}
+
+void FramePacer::updateRefreshRate()
+{
+    QScreen* screen = m_window ? m_window->screen() : nullptr;
+    const qreal refreshRate = screen ? screen->refreshRate() : 0.0;
+
+    // 部分平台报告的刷新率无效，按60Hz处理
+    m_refreshRate = (refreshRate >= 20.0 && refreshRate <= 1000.0) ? refreshRate : 60.0;
+    m_frameIntervalNs = static_cast<qint64>(1e9 / m_refreshRate);
+}
+
+void FramePacer::present()
+{
+    if (!m_pending) return;
+
+    const qint64 now = m_clock.nsecsElapsed();
+
+    // 本帧最迟应在请求后（且距上一帧满一个周期后）的下一个刷新周期内呈现，超出部分计为丢帧
+    qint64 earliest = m_requestNs;
+    if (m_lastFrameNs >= 0) {
+        earliest = qMax(earliest, m_lastFrameNs + m_frameIntervalNs);
+    }
+    const qint64 deadline = earliest + m_frameIntervalNs;
+    if (now > deadline) {
+        m_stats.dropped += static_cast<quint64>((now - deadline) / m_frameIntervalNs) + 1;
+    }
+
+    m_pending = false;
+    m_lastFrameNs = now;
+    m_stats.presented++;
+
+    emit frameReady();
+}
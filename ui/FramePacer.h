@@ -0,0 +1,64 @@
+#ifndef FRAMEPACER_H
+#define FRAMEPACER_H
+#include <QObject>
+#include <QPointer>
+#include <QTimer>
+#include <QElapsedTimer>
+
+class QWidget;
+class QWindow;
+
+// 渲染节奏控制
+// 把一段时间内的多次重绘请求合并为一帧，通过 QWindow::requestUpdate 等待窗口的下一帧时机，
+// 并按屏幕刷新率限制每个刷新周期最多渲染一次；同时统计实际呈现和错过的帧数
+class FramePacer : public QObject
+{
+    Q_OBJECT
+
+public:
+    // 帧统计
+    struct Stats {
+        quint64 requested;  // 重绘请求次数（含被合并的）
+        quint64 presented;  // 实际呈现的帧数
+        quint64 dropped;    // 有待绘制内容却错过的刷新周期数
+
+        Stats() : requested(0), presented(0), dropped(0) {}
+    };
+
+    explicit FramePacer(QWidget* target);
+    ~FramePacer();
+
+    // 请求在下一帧重绘（同一帧内的多次请求只触发一次 frameReady）
+    void requestFrame();
+
+    qreal getRefreshRate() const { return m_refreshRate; }
+    const Stats& getStats() const { return m_stats; }
+    void resetStats() { m_stats = Stats(); }
+
+signals:
+    // 到达帧时机，接收方应在此时按最新状态发起重绘
+    void frameReady();
+
+protected:
+    bool eventFilter(QObject* watched, QEvent* event) override;
+
+private:
+    void attachWindow();        // 跟随目标控件所在的顶层窗口
+    void updateRefreshRate();   // 读取当前屏幕刷新率
+    void present();             // 呈现一帧并更新统计
+
+    QWidget* m_target;
+    QPointer<QWindow> m_window;
+    QTimer m_deferTimer;        // 距上一帧不足一个刷新周期时延后呈现
+    QElapsedTimer m_clock;
+
+    qreal m_refreshRate;        // 屏幕刷新率（Hz）
+    qint64 m_frameIntervalNs;   // 刷新周期
+    qint64 m_lastFrameNs;       // 上一帧呈现时间
+    qint64 m_requestNs;         // 当前待绘制帧的首次请求时间
+    bool m_pending;             // 是否有待绘制的帧
+
+    Stats m_stats;
+};
+
+#endif // FRAMEPACER_H
@@ -1,4 +1,6 @@
 #include <QPainter>
+#include <QPaintEvent>
+#include <QResizeEvent>
 #include "GameWidget.h"
 #include "GameConfig.h"
 #include "GameConfig.h"
@@ -7,9 +9,116 @@
 GameWidget::GameWidget(QWidget* parent)
     : QWidget(parent)
     , m_engine(nullptr)
+    , m_theme(Theme::defaultTheme())
+    , m_perfOverlay(nullptr)
+    , m_renderWorker(new RenderWorker())
+    , m_frameCellSize(0)
+    , m_renderInFlight(false)
+    , m_frameDeferred(false)
+    , m_cellSize(FIELD_CELL_SIZE)
+    , m_fallOffset(0)
+    , m_pendingLineClearCount(0)
+    , m_pendingLockCount(0)
+    , m_effectTop(0)
+    , m_effectBottom(0)
+    , m_effectEnd(0)
+    , m_activeInputTimestamp(-1)
+    , m_inputTimestamp(-1)
+    , m_displayedInputTimestamp(-1)
 {
-    setFixedSize(GAMEWIDGET_FIXED_SIZEW, GAMEWIDGET_FIXED_SIZEH);
+    // 大小随窗口变化，格子大小由可用区域决定
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
     setFocusPolicy(Qt::StrongFocus);
+
+    m_resizeTimer.setSingleShot(true);
+    m_resizeTimer.setInterval(RESIZE_DEBOUNCE_MS);
+    connect(&m_resizeTimer, &QTimer::timeout, this, &GameWidget::applyLayout);
+
+    m_clock.start();
+
+    m_framePacer = new FramePacer(this);
+    connect(m_framePacer, &FramePacer::frameReady, this, &GameWidget::onFrameReady);
+
+    // 性能浮层默认隐藏（F3 切换）
+    m_perfOverlay = new PerfOverlay(m_framePacer, this);
+    m_perfOverlay->move(8, 8);
+    m_perfOverlay->hide();
+
+    // 渲染线程：快照按值排队传入，完成的画面排队传回
+    qRegisterMetaType<FrameSnapshot>();
+    m_renderWorker->moveToThread(&m_renderThread);
+    connect(&m_renderThread, &QThread::finished, m_renderWorker, &QObject::deleteLater);
+    connect(this, &GameWidget::snapshotReady, m_renderWorker, &RenderWorker::render);
+    connect(m_renderWorker, &RenderWorker::frameReady, this, &GameWidget::onFrameRendered);
+    m_renderThread.setObjectName("RenderThread");
+    m_renderThread.start();
+}
+
+GameWidget::~GameWidget()
+{
+    m_renderThread.quit();
+    m_renderThread.wait();
+
+    if (m_latencyStats.samples > 0) {
+        qDebug() << "GameWidget: input latency avg" << m_latencyStats.totalNs / m_latencyStats.samples / 1000
+                 << "us, max" << m_latencyStats.maxNs / 1000 << "us over" << m_latencyStats.samples << "inputs";
+    }
+}
+
+QSize GameWidget::sizeHint() const
+{
+    return QSize(GAMEWIDGET_FIXED_SIZEW, GAMEWIDGET_FIXED_SIZEH);
+}
+
+QSize GameWidget::minimumSizeHint() const
+{
+    return fieldDimensions() * MIN_CELL_SIZE;
+}
+
+QSize GameWidget::fieldDimensions() const
+{
+    if (m_engine) {
+        return m_engine->getGameField().getBounds().size();
+    }
+    return QSize(FIELD_WIDTH, FIELD_HEIGHT);
+}
+
+QRect GameWidget::layoutFieldRect() const
+{
+    // 取能完整放下场地的最大整数格子大小，场地居中
+    const QSize dimensions = fieldDimensions();
+    const int cellSize = qMax(MIN_CELL_SIZE, qMin(width() / dimensions.width(), height() / dimensions.height()));
+    const QSize fieldSize = dimensions * cellSize;
+    return QRect(QPoint((width() - fieldSize.width()) / 2, (height() - fieldSize.height()) / 2), fieldSize);
+}
+
+void GameWidget::resizeEvent(QResizeEvent* event)
+{
+    QWidget::resizeEvent(event);
+
+    // 首次布局立即生效；拖动调整大小时推迟到停止后再按新尺寸重建贴图和图层
+    if (m_frame.isNull()) {
+        applyLayout();
+    } else {
+        m_resizeTimer.start();
+    }
+}
+
+void GameWidget::applyLayout()
+{
+    const QRect fieldRect = layoutFieldRect();
+    const int cellSize = fieldRect.width() / fieldDimensions().width();
+
+    // 格子大小或场地位置变化时重新合成画面（设备像素比变化由渲染线程在合成时处理）；
+    // 方块覆盖的区域按旧位置记录，不能再用于擦除
+    if (cellSize != m_cellSize || fieldRect.topLeft() != m_fieldOrigin) {
+        m_cellSize = cellSize;
+        m_fieldOrigin = fieldRect.topLeft();
+        m_pieceRegion = QRegion();
+        onFullFrameRequested();
+    }
+
+    update();
 }
 
 void GameWidget::setGameEngine(GameEngine* engine)
@@ -17,208 +126,462 @@ void GameWidget::setGameEngine(GameEngine* engine)
     m_engine = engine;
 
     if (m_engine) {
-        connect(m_engine, &GameEngine::gameFieldChanged, this, QOverload<>::of(&QWidget::update));
-        connect(m_engine, &GameEngine::currentBlockChanged, this, QOverload<>::of(&QWidget::update));
+        connect(m_engine, &GameEngine::gameFieldChanged, this, &GameWidget::onEngineFrameRequested);
+        connect(m_engine, &GameEngine::gameStateChanged, this, &GameWidget::onEngineFrameRequested);
+        connect(m_engine, &GameEngine::currentBlockChanged, this, &GameWidget::onCurrentBlockChanged);
+        connect(m_engine, &GameEngine::blockLocked, this, &GameWidget::onBlockLocked);
+        connect(m_engine, &GameEngine::linesRemoved, this, &GameWidget::onLinesRemoved);
     } else {
         qDebug() << "ERROR: Game engine is null in setGameEngine";
     }
 }
 
+void GameWidget::setTheme(const Theme* theme)
+{
+    if (!theme || theme == m_theme) return;
+
+    m_theme = theme;
+    onFullFrameRequested();
+}
+
+void GameWidget::beginInput(qint64 timestamp)
+{
+    m_activeInputTimestamp = timestamp;
+}
+
+void GameWidget::endInput()
+{
+    // 没有引起重绘的输入（未改变状态、被挡住的移动、暂停中的按键等）不计入统计
+    m_activeInputTimestamp = -1;
+}
+
+void GameWidget::adoptInput()
+{
+    // 同一帧内的多次输入按最早的一次计算
+    if (m_activeInputTimestamp >= 0 && m_inputTimestamp < 0) {
+        m_inputTimestamp = m_activeInputTimestamp;
+    }
+}
+
+void GameWidget::togglePerfOverlay()
+{
+    m_perfOverlay->setVisible(!m_perfOverlay->isVisible());
+}
+
 void GameWidget::paintEvent(QPaintEvent* event)
 {
-    Q_UNUSED(event);
+    const qint64 paintStart = m_clock.nsecsElapsed();
 
-    if (!m_engine) return;
+    paintFrame(event->region());
+
+    PERF_STATS.increment(PerfStats::COUNTER_REPAINT);
+    PERF_STATS.record(PerfStats::CHANNEL_PAINT, m_clock.nsecsElapsed() - paintStart);
+}
 
+void GameWidget::paintFrame(const QRegion& region)
+{
     QPainter painter(this);
-    painter.setRenderHint(QPainter::Antialiasing);
 
-    // 绘制背景
-    painter.fillRect(rect(), QColor(20, 20, 20));
+    // 尚无画面时只填充背景
+    if (m_frame.isNull()) {
+        painter.fillRect(rect(), QColor(20, 20, 20));
+        return;
+    }
+
+    // 窗口移到设备像素比不同的屏幕后，按新比例重新合成
+    if (!qFuzzyCompare(m_frame.devicePixelRatio(), devicePixelRatioF())) {
+        onFullFrameRequested();
+    }
 
-    // 绘制游戏场地
-    const auto& field = m_engine->getGameField();
+    // 调整大小期间和新画面到达之前，把已有画面缩放到新的场地区域（仅过渡用）
+    const QRect fieldRect = m_resizeTimer.isActive() ? layoutFieldRect() : QRect(m_fieldOrigin, fieldDimensions() * m_cellSize);
 
-    // 绘制网格
-    painter.setPen(QPen(QColor(40, 40, 40), 1));
-    for (int x = 0; x <= field.getWidth(); ++x) {
-        painter.drawLine(x * FIELD_CELL_SIZE, 0, x * FIELD_CELL_SIZE, field.getHeight() * FIELD_CELL_SIZE);
+    if (m_resizeTimer.isActive() || m_frameCellSize != m_cellSize) {
+        painter.fillRect(rect(), QColor(20, 20, 20));
+        painter.drawImage(fieldRect, m_frame);
+        return;
     }
-    for (int y = 0; y <= field.getHeight(); ++y) {
-        painter.drawLine(0, y * FIELD_CELL_SIZE, field.getWidth() * FIELD_CELL_SIZE, y * FIELD_CELL_SIZE);
+
+    // 只重绘需要更新的区域，每个矩形贴一次图（画面按物理像素合成，整数设备像素比下为 1:1）
+    const qreal scaleX = static_cast<qreal>(m_frame.width()) / fieldRect.width();
+    const qreal scaleY = static_cast<qreal>(m_frame.height()) / fieldRect.height();
+    for (const QRect& rect : region.intersected(fieldRect)) {
+        const QRect source = rect.translated(-fieldRect.topLeft());
+        painter.drawImage(QRectF(rect), m_frame,
+                          QRectF(source.x() * scaleX, source.y() * scaleY, source.width() * scaleX, source.height() * scaleY));
     }
 
-    // 绘制已放置的方块
-    drawGameField(painter);
+    // 场地以外的部分填充背景色
+    for (const QRect& rect : region.subtracted(fieldRect)) {
+        painter.fillRect(rect, QColor(20, 20, 20));
+    }
 
-    // 绘制幽灵方块
-    if (m_engine->getGameState() == GameEngine::STATE_RUNNING && GHOST_BLOCK_ENABLED) {
-        drawGhostBlock(painter);
+    // 画面已显示，记录其反映的输入的延迟
+    if (m_displayedInputTimestamp >= 0) {
+        const qint64 latency = GameClock::now() - m_displayedInputTimestamp;
+        m_latencyStats.samples++;
+        m_latencyStats.totalNs += latency;
+        m_latencyStats.maxNs = qMax(m_latencyStats.maxNs, latency);
+        m_displayedInputTimestamp = -1;
     }
+}
 
-    // 绘制当前方块
-    if (m_engine->getGameState() == GameEngine::STATE_RUNNING) {
-        drawCurrentBlock(painter);
+void GameWidget::onCurrentBlockChanged()
+{
+    PERF_STATS.increment(PerfStats::COUNTER_SIGNAL);
+    adoptInput();
+
+    // 新位置在帧时机按最新状态计算，同一帧内的多次移动合并为一次重绘
+    m_framePacer->requestFrame();
+}
+
+void GameWidget::onEngineFrameRequested()
+{
+    PERF_STATS.increment(PerfStats::COUNTER_SIGNAL);
+    adoptInput();
+    onFullFrameRequested();
+}
+
+void GameWidget::onFullFrameRequested()
+{
+    m_pendingRegion = rect();
+    m_framePacer->requestFrame();
+}
+
+void GameWidget::onBlockLocked(const Block& block)
+{
+    PERF_STATS.increment(PerfStats::COUNTER_SIGNAL);
+
+    if (!PARTICLE_EFFECTS || !block.isValid()) return;
+
+    if (m_pendingLockCount >= FrameSnapshot::MAX_LOCKS) {
+        qDebug() << "WARNING: Too many locks in one frame, dropping one";
+        m_pendingLockCount = FrameSnapshot::MAX_LOCKS - 1;
     }
+    m_pendingLocks[m_pendingLockCount++] = block;
+
+    // 火花略微向上溅起后落到场地底部
+    const QRect bounds = block.getBoundingBox();
+    extendEffect(bounds.top() - 2, fieldDimensions().height(),
+                 m_clock.nsecsElapsed() + static_cast<qint64>(ParticleSystem::MAX_LIFETIME_MS) * 1000000);
+
+    m_framePacer->requestFrame();
 }
 
-void GameWidget::drawGameField(QPainter& painter)
+void GameWidget::onLinesRemoved(const LineClearEvent& event)
 {
-    if (!m_engine) return;
+    PERF_STATS.increment(PerfStats::COUNTER_SIGNAL);
 
-    const auto& field = m_engine->getGameField();
+    if (event.rowCount <= 0) return;
 
-    // 绘制已放置的方块
-    for (int y = 0; y < field.getHeight(); ++y) {
-        for (int x = 0; x < field.getWidth(); ++x) {
-            if (!field.isCellEmpty(x, y)) {
-                QColor color = field.getCellColor(x, y);
+    // 配置了消行等待时动画与等待时间同步，否则使用默认时长
+    const qint64 now = m_clock.nsecsElapsed();
+    const int durationMs = LINE_CLEAR_DELAY > 0 ? LINE_CLEAR_DELAY : LineClearAnimator::DEFAULT_DURATION_MS;
 
-                // 绘制方块主体
-                painter.fillRect(x * FIELD_CELL_SIZE, y * FIELD_CELL_SIZE, FIELD_CELL_SIZE, FIELD_CELL_SIZE, color);
+    // 一帧内的消行超过上限时（实际不会发生）覆盖最后一个
+    if (m_pendingLineClearCount >= FrameSnapshot::MAX_LINE_CLEARS) {
+        qDebug() << "WARNING: Too many line clears in one frame, dropping one";
+        m_pendingLineClearCount = FrameSnapshot::MAX_LINE_CLEARS - 1;
+    }
 
-                // 绘制高光效果
-                painter.setPen(QPen(QColor(255, 255, 255, 150), 2));
-                painter.drawLine(x * FIELD_CELL_SIZE, y * FIELD_CELL_SIZE, (x + 1) * FIELD_CELL_SIZE, y * FIELD_CELL_SIZE);
-                painter.drawLine(x * FIELD_CELL_SIZE, y * FIELD_CELL_SIZE, x * FIELD_CELL_SIZE, (y + 1) * FIELD_CELL_SIZE);
+    LineClearEffect& effect = m_pendingLineClears[m_pendingLineClearCount++];
+    effect.event = event;
+    effect.startTime = now;
+    effect.duration = static_cast<qint64>(durationMs) * 1000000;
 
-                // 绘制阴影效果
-                painter.setPen(QPen(QColor(0, 0, 0, 100), 2));
-                painter.drawLine((x + 1) * FIELD_CELL_SIZE, y * FIELD_CELL_SIZE, (x + 1) * FIELD_CELL_SIZE, (y + 1) * FIELD_CELL_SIZE);
-                painter.drawLine(x * FIELD_CELL_SIZE, (y + 1) * FIELD_CELL_SIZE, (x + 1) * FIELD_CELL_SIZE, (y + 1) * FIELD_CELL_SIZE);
+    // 记录动画覆盖的行（消除前的行号，即动画绘制的位置）
+    extendEffect(event.rows[0], event.rows[event.rowCount - 1] + 1, now + effect.duration);
 
-                // 绘制内部细节
-                painter.setPen(QPen(QColor(255, 255, 255, 50), 1));
-                painter.drawRect(x * FIELD_CELL_SIZE + 2, y * FIELD_CELL_SIZE + 2, FIELD_CELL_SIZE - 4, FIELD_CELL_SIZE - 4);
-            }
-        }
+    // 碎片向上抛出后落到场地底部
+    if (PARTICLE_EFFECTS) {
+        extendEffect(event.rows[0] - 2, fieldDimensions().height(),
+                     now + static_cast<qint64>(ParticleSystem::MAX_LIFETIME_MS) * 1000000);
     }
+
+    m_framePacer->requestFrame();
 }
 
-void GameWidget::drawGhostBlock(QPainter& painter)
+void GameWidget::extendEffect(int top, int bottom, qint64 end)
 {
-    if (!m_engine || m_engine->getGameState() != GameEngine::STATE_RUNNING) return;
+    top = qMax(top, 0);
+    if (m_effectTop >= m_effectBottom) {
+        m_effectTop = top;
+        m_effectBottom = bottom;
+    } else {
+        m_effectTop = qMin(m_effectTop, top);
+        m_effectBottom = qMax(m_effectBottom, bottom);
+    }
+    m_effectEnd = qMax(m_effectEnd, end);
+}
 
-    // 获取幽灵方块
-    Block ghostBlock = m_engine->getGhostBlock();
+QRegion GameWidget::effectRegion() const
+{
+    if (m_effectTop >= m_effectBottom) {
+        return QRegion();
+    }
 
-    // 如果幽灵方块位置与当前方块位置相同（已经在底部），则不绘制
-    if (ghostBlock.getPosition().y == m_engine->getCurrentBlock().getPosition().y) {
+    return QRegion(m_fieldOrigin.x(), m_fieldOrigin.y() + m_effectTop * m_cellSize,
+                   fieldDimensions().width() * m_cellSize, (m_effectBottom - m_effectTop) * m_cellSize);
+}
+
+void GameWidget::onFrameReady()
+{
+    if (!m_engine) return;
+
+    // 上一帧仍在渲染时不重复提交，等其完成后再请求下一帧
+    if (m_renderInFlight) {
+        m_frameDeferred = true;
         return;
     }
 
-    auto cells = ghostBlock.getOccupiedCells();
-    QColor ghostColor = ghostBlock.getColor();
+    // 本帧的下落偏移在帧时机确定，重绘区域和绘制位置保持一致
+    m_fallOffset = currentFallOffset();
+
+    // 擦除当前显示的方块，新区域按最新状态计算，中间经过的位置无需绘制
+    m_submittedPieceRegion = pieceRegion();
+    m_submittedRegion = m_pendingRegion | m_pieceRegion | m_submittedPieceRegion;
+    m_pendingRegion = QRegion();
+
+    // 效果播放期间每帧重绘其覆盖的行；结束后的这一帧不再绘制效果，用来擦除最后的画面
+    const qint64 frameTime = m_clock.nsecsElapsed();
+    bool animating = false;
+    if (m_effectTop < m_effectBottom) {
+        m_submittedRegion |= effectRegion();
+        animating = frameTime < m_effectEnd;
+        if (!animating) {
+            m_effectTop = m_effectBottom = 0;
+        }
+    }
+
+    // 构造快照，之后的引擎变化不影响本帧
+    const bool running = m_engine->getGameState() == GameEngine::STATE_RUNNING;
+    FrameSnapshot snapshot;
+    snapshot.field = m_engine->getGameField();
+    if (running) {
+        snapshot.current = m_engine->getCurrentBlock();
+    }
+    if (isGhostVisible()) {
+        snapshot.ghost = m_engine->getGhostBlock();
+    }
+    snapshot.fallOffset = static_cast<float>(m_fallOffset) / m_cellSize;
+    snapshot.cellSize = m_cellSize;
+    snapshot.devicePixelRatio = devicePixelRatioF();
+    snapshot.theme = m_theme;
+    snapshot.inputTimestamp = m_inputTimestamp;
+    m_inputTimestamp = -1;
+    snapshot.frameTime = frameTime;
+    for (int i = 0; i < m_pendingLineClearCount; ++i) {
+        snapshot.lineClears[i] = m_pendingLineClears[i];
+    }
+    snapshot.lineClearCount = m_pendingLineClearCount;
+    m_pendingLineClearCount = 0;
+    for (int i = 0; i < m_pendingLockCount; ++i) {
+        snapshot.locks[i] = m_pendingLocks[i];
+    }
+    snapshot.lockCount = m_pendingLockCount;
+    m_pendingLockCount = 0;
+
+    m_renderInFlight = true;
+    emit snapshotReady(snapshot);
 
-    // 设置幽灵方块的颜色（半透明）
-    ghostColor.setAlpha(80);
+    // 平滑下落时方块在两次模拟步进之间也在移动，消行动画和粒子也需要逐帧播放，每个刷新周期都需要重绘
+    if ((SMOOTH_FALL && running) || animating) {
+        m_framePacer->requestFrame();
+    }
+}
 
-    // 绘制幽灵方块
-    for (const auto& cell : std::as_const(cells)) {
-        if (cell.y >= 0) {
-            // 绘制虚影
-            painter.fillRect(cell.x * FIELD_CELL_SIZE, cell.y * FIELD_CELL_SIZE, FIELD_CELL_SIZE, FIELD_CELL_SIZE, ghostColor);
-        }
+void GameWidget::onFrameRendered(const QImage& frame, int cellSize, qint64 inputTimestamp)
+{
+    m_frame = frame;
+    m_frameCellSize = cellSize;
+    m_renderInFlight = false;
+    m_pieceRegion = m_submittedPieceRegion;
+    if (inputTimestamp >= 0 && m_displayedInputTimestamp < 0) {
+        m_displayedInputTimestamp = inputTimestamp;
     }
 
-    // 可选：绘制从当前方块到幽灵方块的连线
-    // if (cells.size() > 0) {
-    //     const auto& currentBlock = m_engine->getCurrentBlock();
-    //     auto currentCells = currentBlock.getOccupiedCells();
+    if (m_resizeTimer.isActive()) {
+        update();  // 调整大小期间整体缩放绘制
+    } else if (!m_submittedRegion.isEmpty()) {
+        update(m_submittedRegion);
+    }
 
-    //     if (currentCells.size() > 0 && cells.size() > 0) {
-    //         // 找到当前方块和幽灵方块的中心点
-    //         Position currentCenter = currentCells[0];
-    //         Position ghostCenter = cells[0];
+    // 渲染期间积压的请求
+    if (m_frameDeferred) {
+        m_frameDeferred = false;
+        m_framePacer->requestFrame();
+    }
+}
 
-    //         // 计算中心点（取所有细胞的平均值）
-    //         for (int i = 1; i < currentCells.size(); i++) {
-    //             currentCenter.x += currentCells[i].x;
-    //             currentCenter.y += currentCells[i].y;
-    //         }
-    //         for (int i = 1; i < cells.size(); i++) {
-    //             ghostCenter.x += cells[i].x;
-    //             ghostCenter.y += cells[i].y;
-    //         }
+int GameWidget::currentFallOffset() const
+{
+    if (!m_engine) return 0;
 
-    //         currentCenter.x /= currentCells.size();
-    //         currentCenter.y /= currentCells.size();
-    //         ghostCenter.x /= cells.size();
-    //         ghostCenter.y /= cells.size();
+    if (SMOOTH_FALL) {
+        // 按距上次模拟步进的时间插值，锁定、硬降和落地时引擎返回0，方块立即贴齐格子
+        return qRound(m_engine->getInterpolatedFall() * m_cellSize);
+    }
 
-    //         // 绘制虚线连接线
-    //         QPen linePen(QColor(255, 255, 255, 80));
-    //         linePen.setStyle(Qt::DotLine);
-    //         linePen.setWidth(1);
-    //         painter.setPen(linePen);
+    // 对下落进度取整，防止出现在某一格内的情况
+    return static_cast<int>(trunc(m_engine->getFallProgress())) * m_cellSize;
+}
 
-    //         painter.drawLine(
-    //             currentCenter.x * FIELD_CELL_SIZE + FIELD_CELL_SIZE / 2,
-    //             currentCenter.y * FIELD_CELL_SIZE + FIELD_CELL_SIZE / 2,
-    //             ghostCenter.x * FIELD_CELL_SIZE + FIELD_CELL_SIZE / 2,
-    //             ghostCenter.y * FIELD_CELL_SIZE + FIELD_CELL_SIZE / 2
-    //         );
-    //     }
-    // }
+QRect GameWidget::blockRect(const Block& block, int offsetY) const
+{
+    const QRect bounds = block.getBoundingBox();
+    return QRect(m_fieldOrigin.x() + bounds.x() * m_cellSize, m_fieldOrigin.y() + bounds.y() * m_cellSize + offsetY,
+                 bounds.width() * m_cellSize, bounds.height() * m_cellSize);
 }
 
-void GameWidget::drawCurrentBlock(QPainter& painter)
+QRegion GameWidget::pieceRegion() const
 {
-    if (!m_engine || m_engine->getGameState() != GameEngine::STATE_RUNNING) return;
+    if (!m_engine || m_engine->getGameState() != GameEngine::STATE_RUNNING) {
+        return QRegion();
+    }
 
-    const auto& currentBlock = m_engine->getCurrentBlock();
-    auto cells = currentBlock.getOccupiedCells();
-    QColor blockColor = currentBlock.getColor();
+    // 上下各留1像素，覆盖非整数设备像素比下的取整误差
+    const Block& currentBlock = m_engine->getCurrentBlock();
+    QRegion region(blockRect(currentBlock, m_fallOffset).adjusted(0, -1, 0, 1));
 
-    // 获取下落进度
-    float fallProgress = m_engine->getFallProgress();
+    if (isGhostVisible()) {
+        region += blockRect(m_engine->getGhostBlock());
+    }
 
-    painter.setBrush(blockColor);
-    painter.setPen(QPen(Qt::white, 2));
+    return region.intersected(rect());
+}
 
-    for (const auto& cell : std::as_const(cells)) {
-        // 计算实际绘制位置（包括下落进度）
-        float actualY = cell.y + static_cast<int>(trunc(fallProgress));  // 对下落进度取整，防止出现在某一格内的情况
-        int drawY = actualY * FIELD_CELL_SIZE;
-
-        // 只绘制场地内的部分
-        if (actualY >= 0 && actualY < m_engine->getGameField().getHeight()) {
-            painter.drawRect(cell.x * FIELD_CELL_SIZE, drawY, FIELD_CELL_SIZE, FIELD_CELL_SIZE);
-
-            // 绘制高光效果
-            painter.setPen(QPen(QColor(255, 255, 255, 200), 2));
-            painter.drawLine(cell.x * FIELD_CELL_SIZE, drawY, (cell.x + 1) * FIELD_CELL_SIZE, drawY);
-            painter.drawLine(cell.x * FIELD_CELL_SIZE, drawY, cell.x * FIELD_CELL_SIZE, drawY + FIELD_CELL_SIZE);
-
-            // 绘制阴影效果
-            painter.setPen(QPen(QColor(0, 0, 0, 100), 2));
-            painter.drawLine((cell.x + 1) * FIELD_CELL_SIZE, drawY, (cell.x + 1) * FIELD_CELL_SIZE, drawY + FIELD_CELL_SIZE);
-            painter.drawLine(cell.x * FIELD_CELL_SIZE, drawY + FIELD_CELL_SIZE, (cell.x + 1) * FIELD_CELL_SIZE, drawY + FIELD_CELL_SIZE);
-        }
+bool GameWidget::isGhostVisible() const
+{
+    if (!m_engine || m_engine->getGameState() != GameEngine::STATE_RUNNING || !GHOST_BLOCK_ENABLED) {
+        return false;
     }
+
+    // 如果幽灵方块位置与当前方块位置相同（已经在底部），则不绘制
+    return m_engine->getGhostBlock().getPosition().y != m_engine->getCurrentBlock().getPosition().y;
 }
 
-// 下一个方块的预览实现
-NextBlockWidget::NextBlockWidget(QWidget* parent)
+// 单个方块预览的基类实现
+BlockPreviewWidget::BlockPreviewWidget(QWidget* parent)
     : QWidget(parent)
+    , m_theme(Theme::defaultTheme())
+    , m_frameIndex(0)
+    , m_frameDevicePixelRatio(0.0)
 {
     setFixedSize(BLOCKWIDGET_FIXED_SIZEW, BLOCKWIDGET_FIXED_SIZEH);  // 固定大小，适合显示方块
     setStyleSheet("background-color: rgba(30, 30, 30, 200); border: 2px solid gray;");
 }
 
-void NextBlockWidget::setNextBlock(const Block& block)
+void BlockPreviewWidget::showBlock(const Block& block)
 {
-    m_nextBlock = block;
-    update();  // 触发重绘
+    const int index = block.isValid() ? block.getType() + 1 : 0;
+    m_block = block;
+
+    if (index != m_frameIndex) {
+        m_frameIndex = index;
+        update();  // 触发重绘
+    }
 }
 
-void NextBlockWidget::paintEvent(QPaintEvent* event)
+void BlockPreviewWidget::setTheme(const Theme* theme)
+{
+    if (!theme || theme == m_theme) return;
+
+    m_theme = theme;
+    invalidateFrames();
+    update();
+}
+
+CellSpriteCache& BlockPreviewWidget::sharedSprites()
+{
+    // 只在界面线程中使用
+    static CellSpriteCache s_sprites;
+    return s_sprites;
+}
+
+void BlockPreviewWidget::ensureFrame()
+{
+    // 设备像素比变化（窗口移到其他屏幕）时按新比例重新渲染
+    const qreal dpr = devicePixelRatioF();
+    if (!qFuzzyCompare(dpr, m_frameDevicePixelRatio)) {
+        invalidateFrames();
+        m_frameDevicePixelRatio = dpr;
+    }
+
+    if (m_frameIndex >= m_frames.size()) {
+        m_frames.resize(m_frameIndex + 1);
+    }
+
+    // 首次出现的方块类型渲染一次完整画面
+    if (m_frames[m_frameIndex].isNull()) {
+        QImage frame(size() * dpr, QImage::Format_ARGB32_Premultiplied);
+        frame.setDevicePixelRatio(dpr);
+        frame.fill(Qt::transparent);
+        {
+            QPainter painter(&frame);
+            painter.setFont(font());
+            renderFrame(painter, m_block);
+        }
+        m_frames[m_frameIndex] = frame;
+    }
+}
+
+void BlockPreviewWidget::invalidateFrames()
+{
+    m_frames.clear();
+}
+
+void BlockPreviewWidget::paintEvent(QPaintEvent* event)
 {
     Q_UNUSED(event);
 
+    ensureFrame();
+
     QPainter painter(this);
-    painter.setRenderHint(QPainter::Antialiasing);
+    painter.drawImage(0, 0, m_frames[m_frameIndex]);
+}
+
+void BlockPreviewWidget::drawBlockCentered(QPainter& painter, const Block& block)
+{
+    // 贴图按物理像素大小从图集中取，画面按设备像素比渲染，贴图时 1:1 对应
+    CellSpriteCache& sprites = sharedSprites();
+    sprites.setCellSize(qRound(WIDGET_CELL_SIZE * m_frameDevicePixelRatio));
+    sprites.setTheme(m_theme);
+    const CellSpriteCache::Sprite sprite = sprites.sprite(block.getType(), block.getColor(), CellSpriteCache::STYLE_PREVIEW);
+
+    // 获取方块的单元格
+    auto cells = block.getOccupiedCells();
+
+    // 计算居中位置
+    QRect blockBounds = block.getBoundingBox();
+    int blockWidth = blockBounds.width() * WIDGET_CELL_SIZE;
+    int blockHeight = blockBounds.height() * WIDGET_CELL_SIZE;
+
+    int startX = (width() - blockWidth) / 2;
+    int startY = (height() - blockHeight) / 2 + 15;  // 向下偏移为标题留空间
+
+    for (const auto& cell : std::as_const(cells)) {
+        // 计算在预览窗口中的位置（相对于方块边界）
+        int drawX = startX + (cell.x - blockBounds.x()) * WIDGET_CELL_SIZE;
+        int drawY = startY + (cell.y - blockBounds.y()) * WIDGET_CELL_SIZE;
+
+        painter.drawImage(QRect(drawX, drawY, WIDGET_CELL_SIZE, WIDGET_CELL_SIZE), *sprite.image, sprite.rect);
+    }
+}
+
+// 下一个方块的预览实现
+NextBlockWidget::NextBlockWidget(QWidget* parent)
+    : BlockPreviewWidget(parent)
+    , m_title("下一个:")
+{
+}
 
+void NextBlockWidget::setNextBlock(const Block& block)
+{
+    showBlock(block);
+}
+
+void NextBlockWidget::renderFrame(QPainter& painter, const Block& block)
+{
     // 绘制背景
     painter.fillRect(rect(), QColor(30, 30, 30, 200));
 
@@ -228,73 +591,197 @@ void NextBlockWidget::paintEvent(QPaintEvent* event)
 
     // 绘制标题
     painter.setPen(Qt::white);
-    painter.drawText(rect().adjusted(5, 5, -5, -5), Qt::AlignTop | Qt::AlignLeft, "下一个:");
+    painter.drawStaticText(5, 5, m_title);
 
     // 如果没有下一个方块，不绘制
-    if (m_nextBlock.getType() == Block::TYPE_COUNT) {
+    if (!block.isValid()) {
         return;
     }
 
-    // 获取方块的单元格
-    auto cells = m_nextBlock.getOccupiedCells();
-    QColor blockColor = m_nextBlock.getColor();
+    drawBlockCentered(painter, block);
+}
 
-    // 计算居中位置
-    QRect blockBounds = m_nextBlock.getBoundingBox();
-    int blockWidth = blockBounds.width() * WIDGET_CELL_SIZE;
-    int blockHeight = blockBounds.height() * WIDGET_CELL_SIZE;
+// 预览队列实现
+NextQueueWidget::NextQueueWidget(QWidget* parent)
+    : QWidget(parent)
+    , m_previewCount(qBound(1, PREVIEW_COUNT, 6))
+    , m_cellSize(WIDGET_CELL_SIZE * 3 / 4)
+    , m_slotWidth(m_cellSize * 4)
+    , m_slotHeight(m_cellSize * 3)
+    , m_stripDevicePixelRatio(0.0)
+{
+    // 标题占25像素，每个槽位之间留6像素间隔
+    setFixedSize(m_slotWidth + 16, 25 + m_previewCount * (m_slotHeight + 6));
+}
 
-    int startX = (width() - blockWidth) / 2;
-    int startY = (height() - blockHeight) / 2 + 15;  // 向下偏移为标题留空间
+void NextQueueWidget::setQueue(const QVector<Block>& blocks)
+{
+    m_queue.clear();
+    for (const Block& block : blocks) {
+        if (block.isValid()) {
+            m_queue.append(block);
+        }
+    }
+    update();  // 触发重绘
+}
+
+void NextQueueWidget::setTheme(const Theme* theme)
+{
+    if (!theme || theme == m_sprites.getTheme()) return;
+
+    m_sprites.setTheme(theme);
+    m_strip = QImage();
+    m_stripReady.clear();
+    update();
+}
 
-    painter.setBrush(blockColor);
-    painter.setPen(QPen(Qt::white, 1));
+void NextQueueWidget::ensureStrip()
+{
+    // 设备像素比变化（窗口移到其他屏幕）时清空条带，按新比例重新绘制
+    const qreal dpr = devicePixelRatioF();
+    if (!qFuzzyCompare(dpr, m_stripDevicePixelRatio)) {
+        m_strip = QImage();
+        m_stripReady.clear();
+        m_chrome = QImage();
+        m_stripDevicePixelRatio = dpr;
+        m_sprites.setCellSize(qRound(m_cellSize * dpr));
+    }
+    if (m_chrome.isNull()) {
+        renderChrome();
+    }
+
+    // 首次出现的方块类型绘制到缓存条带中，之后只做贴图
+    for (const Block& block : std::as_const(m_queue)) {
+        if (block.getType() >= m_stripReady.size() || !m_stripReady[block.getType()]) {
+            renderStripSlot(block);
+        }
+    }
+}
+
+void NextQueueWidget::renderChrome()
+{
+    m_chrome = QImage(size() * m_stripDevicePixelRatio, QImage::Format_ARGB32_Premultiplied);
+    m_chrome.setDevicePixelRatio(m_stripDevicePixelRatio);
+    m_chrome.fill(Qt::transparent);
+
+    QPainter painter(&m_chrome);
+
+    // 绘制背景
+    painter.fillRect(rect(), QColor(30, 30, 30, 200));
+
+    // 绘制边框
+    painter.setPen(QPen(Qt::gray, 2));
+    painter.drawRect(rect().adjusted(1, 1, -1, -1));
+
+    // 绘制标题
+    painter.setPen(Qt::white);
+    painter.setFont(font());
+    painter.drawText(rect().adjusted(5, 5, -5, -5), Qt::AlignTop | Qt::AlignLeft, "之后:");
+}
+
+void NextQueueWidget::renderStripSlot(const Block& block)
+{
+    // 条带按出现过的最大类型扩展，保留已绘制的槽位
+    if (block.getType() >= m_stripReady.size()) {
+        QImage strip(QSize(m_slotWidth * (block.getType() + 1), m_slotHeight) * m_stripDevicePixelRatio,
+                     QImage::Format_ARGB32_Premultiplied);
+        strip.setDevicePixelRatio(m_stripDevicePixelRatio);
+        strip.fill(Qt::transparent);
+        if (!m_strip.isNull()) {
+            QPainter copier(&strip);
+            copier.drawImage(0, 0, m_strip);
+        }
+        m_strip = strip;
+        m_stripReady.resize(block.getType() + 1);
+    }
+
+    QRect slot(block.getType() * m_slotWidth, 0, m_slotWidth, m_slotHeight);
+
+    QPainter painter(&m_strip);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    painter.fillRect(slot, Qt::transparent);
+    painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+
+    // 方块在槽位内居中，超出槽位的大方块（如五格骨牌）缩小格子
+    auto cells = block.getOccupiedCells();
+    QRect blockBounds = block.getBoundingBox();
+    int cellSize = qMin(m_cellSize, qMin(m_slotWidth / blockBounds.width(), m_slotHeight / blockBounds.height()));
+    int startX = slot.x() + (m_slotWidth - blockBounds.width() * cellSize) / 2;
+    int startY = slot.y() + (m_slotHeight - blockBounds.height() * cellSize) / 2;
+
+    // 贴图从图集中取，格子缩小时缩放绘制
+    const CellSpriteCache::Sprite sprite = m_sprites.sprite(block.getType(), block.getColor(), CellSpriteCache::STYLE_PREVIEW);
+    if (cellSize != m_cellSize) {
+        painter.setRenderHint(QPainter::SmoothPixmapTransform);
+    }
 
     for (const auto& cell : std::as_const(cells)) {
-        // 计算在预览窗口中的位置（相对于方块边界）
-        int drawX = startX + (cell.x - blockBounds.x()) * WIDGET_CELL_SIZE;
-        int drawY = startY + (cell.y - blockBounds.y()) * WIDGET_CELL_SIZE;
+        int drawX = startX + (cell.x - blockBounds.x()) * cellSize;
+        int drawY = startY + (cell.y - blockBounds.y()) * cellSize;
 
-        painter.drawRect(drawX, drawY, WIDGET_CELL_SIZE, WIDGET_CELL_SIZE);
+        painter.drawImage(QRect(drawX, drawY, cellSize, cellSize), *sprite.image, sprite.rect);
+    }
+
+    m_stripReady[block.getType()] = true;
+}
 
-        // 添加简单的3D效果
-        painter.setPen(QPen(QColor(255, 255, 255, 150), 1));
-        painter.drawLine(drawX, drawY, drawX + WIDGET_CELL_SIZE, drawY);
-        painter.drawLine(drawX, drawY, drawX, drawY + WIDGET_CELL_SIZE);
+void NextQueueWidget::paintEvent(QPaintEvent* event)
+{
+    Q_UNUSED(event);
 
-        painter.setPen(QPen(QColor(0, 0, 0, 100), 1));
-        painter.drawLine(drawX + WIDGET_CELL_SIZE, drawY, drawX + WIDGET_CELL_SIZE, drawY + WIDGET_CELL_SIZE);
-        painter.drawLine(drawX, drawY + WIDGET_CELL_SIZE, drawX + WIDGET_CELL_SIZE, drawY + WIDGET_CELL_SIZE);
+    QPainter painter(this);
+
+    ensureStrip();
+
+    // 背景、边框和标题贴一次图，每个方块再从缓存条带贴一次图（源区域按物理像素计算）
+    painter.drawImage(0, 0, m_chrome);
+    const qreal dpr = m_stripDevicePixelRatio;
+    int x = (width() - m_slotWidth) / 2;
+    int y = 25;
+    for (int i = 0; i < m_queue.size() && i < m_previewCount; ++i) {
+        painter.drawImage(QRectF(x, y, m_slotWidth, m_slotHeight), m_strip,
+                          QRectF(m_queue[i].getType() * m_slotWidth * dpr, 0, m_slotWidth * dpr, m_slotHeight * dpr));
+        y += m_slotHeight + 6;
     }
 }
 
 // HoldBlockWidget实现
 HoldBlockWidget::HoldBlockWidget(QWidget* parent)
-    : QWidget(parent)
+    : BlockPreviewWidget(parent)
+    , m_hintFont(font())
+    , m_title("暂存:")
+    , m_emptyText("空")
 {
-    setFixedSize(BLOCKWIDGET_FIXED_SIZEW, BLOCKWIDGET_FIXED_SIZEH);  // 固定大小
-    setStyleSheet("background-color: rgba(30, 30, 30, 200); border: 2px solid gray;");
+    // 提示文字使用小号字体，布局只在按键变化时计算
+    m_hintFont.setPointSize(8);
+    setHoldKeyText("C");
 }
 
 void HoldBlockWidget::setHoldBlock(const Block& block)
 {
-    m_holdBlock = block;
-    update();  // 触发重绘
+    showBlock(block);
 }
 
-void HoldBlockWidget::paintEvent(QPaintEvent* event)
+void HoldBlockWidget::setHoldKeyText(const QString& keys)
 {
-    Q_UNUSED(event);
-
-    QPainter painter(this);
-    painter.setRenderHint(QPainter::Antialiasing);
+    m_emptyHint.setText(QString("按 %1 键暂存").arg(keys));
+    m_heldHint.setText(QString("已暂存 - 按 %1 键交换").arg(keys));
+    m_emptyHint.prepare(QTransform(), m_hintFont);
+    m_heldHint.prepare(QTransform(), m_hintFont);
+
+    // 提示文字画在缓存画面中，需要重新渲染
+    invalidateFrames();
+    update();
+}
 
+void HoldBlockWidget::renderFrame(QPainter& painter, const Block& block)
+{
     // 绘制背景
     painter.fillRect(rect(), QColor(30, 30, 30, 200));
 
     // 绘制边框
     QColor borderColor = Qt::gray;
-    if (m_holdBlock.getType() != Block::TYPE_COUNT && m_holdBlock.isValid()) {
+    if (block.isValid()) {
         borderColor = QColor(255, 215, 0);  // 金色边框表示有暂存方块
     }
     painter.setPen(QPen(borderColor, 2));
@@ -302,60 +789,24 @@ void HoldBlockWidget::paintEvent(QPaintEvent* event)
 
     // 绘制标题
     painter.setPen(Qt::white);
-    painter.drawText(rect().adjusted(5, 5, -5, -5), Qt::AlignTop | Qt::AlignLeft, "暂存:");
+    painter.drawStaticText(5, 5, m_title);
 
     // 如果没有Hold方块或Hold方块是空的，显示提示
-    if (m_holdBlock.getType() == Block::TYPE_COUNT || !m_holdBlock.isValid()) {
+    if (!block.isValid()) {
         painter.setPen(QColor(100, 100, 100));
-        painter.drawText(rect().center(), "空");
+        painter.drawStaticText(rect().center().x(), rect().center().y() - painter.fontMetrics().ascent(), m_emptyText);
 
         // 添加提示文字
         painter.setPen(QColor(150, 150, 150));
-        QFont font = painter.font();
-        font.setPointSize(8);
-        painter.setFont(font);
-        painter.drawText(rect().adjusted(5, height() - 20, -5, -5),
-                         Qt::AlignBottom | Qt::AlignLeft, "按 C 键暂存");
+        painter.setFont(m_hintFont);
+        painter.drawStaticText(5, height() - 5 - qRound(m_emptyHint.size().height()), m_emptyHint);
         return;
     }
 
-    // 获取方块的单元格
-    auto cells = m_holdBlock.getOccupiedCells();
-    QColor blockColor = m_holdBlock.getColor();
-
-    // 计算居中位置
-    QRect blockBounds = m_holdBlock.getBoundingBox();
-    int blockWidth = blockBounds.width() * WIDGET_CELL_SIZE;
-    int blockHeight = blockBounds.height() * WIDGET_CELL_SIZE;
-
-    int startX = (width() - blockWidth) / 2;
-    int startY = (height() - blockHeight) / 2 + 15;  // 向下偏移为标题留空间
-
-    painter.setBrush(blockColor);
-    painter.setPen(QPen(Qt::white, 1));
-
-    for (const auto& cell : std::as_const(cells)) {
-        // 计算在预览窗口中的位置（相对于方块边界）
-        int drawX = startX + (cell.x - blockBounds.x()) * WIDGET_CELL_SIZE;
-        int drawY = startY + (cell.y - blockBounds.y()) * WIDGET_CELL_SIZE;
-
-        painter.drawRect(drawX, drawY, WIDGET_CELL_SIZE, WIDGET_CELL_SIZE);
-
-        // 添加简单的3D效果
-        painter.setPen(QPen(QColor(255, 255, 255, 150), 1));
-        painter.drawLine(drawX, drawY, drawX + WIDGET_CELL_SIZE, drawY);
-        painter.drawLine(drawX, drawY, drawX, drawY + WIDGET_CELL_SIZE);
-
-        painter.setPen(QPen(QColor(0, 0, 0, 100), 1));
-        painter.drawLine(drawX + WIDGET_CELL_SIZE, drawY, drawX + WIDGET_CELL_SIZE, drawY + WIDGET_CELL_SIZE);
-        painter.drawLine(drawX, drawY + WIDGET_CELL_SIZE, drawX + WIDGET_CELL_SIZE, drawY + WIDGET_CELL_SIZE);
-    }
+    drawBlockCentered(painter, block);
 
     // 添加状态提示
     painter.setPen(QColor(200, 200, 200));
-    QFont font = painter.font();
-    font.setPointSize(8);
-    painter.setFont(font);
-    painter.drawText(rect().adjusted(5, height() - 20, -5, -5),
-                     Qt::AlignBottom | Qt::AlignLeft, "已暂存 - 按 C 键交换");
+    painter.setFont(m_hintFont);
+    painter.drawStaticText(5, height() - 5 - qRound(m_heldHint.size().height()), m_heldHint);
 }
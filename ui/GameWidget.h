@@ -1,30 +1,161 @@
 #ifndef GAMEWIDGET_H
 #define GAMEWIDGET_H
 #include <QWidget>
+#include <QImage>
+#include <QRegion>
+#include <QStaticText>
+#include <QFont>
 #include "GameEngine.h"
+#include <QThread>
+#include <QTimer>
+#include <QElapsedTimer>
+#include "RenderWorker.h"
+#include "FramePacer.h"
+#include "PerfOverlay.h"
 
 class GameWidget : public QWidget
 {
     Q_OBJECT
 
 public:
+    // 输入延迟统计（按键到反映该输入的画面绘制完成）
+    struct LatencyStats {
+        quint64 samples;
+        qint64 totalNs;
+        qint64 maxNs;
+
+        LatencyStats() : samples(0), totalNs(0), maxNs(0) {}
+    };
+
+    static constexpr int MIN_CELL_SIZE = 8;         // 最小格子大小（逻辑像素）
+    static constexpr int RESIZE_DEBOUNCE_MS = 120;  // 调整大小结束后多久重建画面
+
     explicit GameWidget(QWidget* parent = nullptr);
+    ~GameWidget();
+
+    QSize sizeHint() const override;
+    QSize minimumSizeHint() const override;
+
     void setGameEngine(GameEngine* engine);
+    void setTheme(const Theme* theme);      // 切换主题，贴图图集在渲染线程中重建
+    const FramePacer* getFramePacer() const { return m_framePacer; }
+    const LatencyStats& getInputLatencyStats() const { return m_latencyStats; }
+
+    // 输入延迟测量：引擎处理一次游戏操作前后调用，timestamp 为收到输入的时间（GameClock 纳秒）；
+    // 只有处理期间引擎请求了重绘（输入实际改变了画面），该输入才计入下一帧的延迟统计
+    void beginInput(qint64 timestamp);
+    void endInput();
+
+    // 显示或隐藏性能浮层
+    void togglePerfOverlay();
+
+signals:
+    void snapshotReady(const FrameSnapshot& snapshot);  // 提交给渲染线程
 
 protected:
     void paintEvent(QPaintEvent* event) override;
+    void resizeEvent(QResizeEvent* event) override;
+
+private slots:
+    void applyLayout();                      // 调整大小结束后按新尺寸确定格子大小
+    void onCurrentBlockChanged();            // 只重绘方块移动前后覆盖的区域
+    void onFullFrameRequested();             // 重绘整个控件
+    void onEngineFrameRequested();           // 引擎要求重绘整个控件（计入信号统计）
+    void onBlockLocked(const Block& block);            // 方块锁定，随下一帧提交火花效果
+    void onLinesRemoved(const LineClearEvent& event);  // 消行，随下一帧提交动画
+    void onFrameReady();                     // 到达帧时机，向渲染线程提交快照
+    void onFrameRendered(const QImage& frame, int cellSize, qint64 inputTimestamp);  // 渲染线程完成合成
 
 private:
+    void paintFrame(const QRegion& region);  // 按重绘区域贴图（paintEvent 在此之外记录耗时）
+
     GameEngine* m_engine;
+    const Theme* m_theme;
+    PerfOverlay* m_perfOverlay;
+
+    // 场地画面在渲染线程中合成，界面线程只按重绘区域贴图
+    QThread m_renderThread;
+    RenderWorker* m_renderWorker;
+    QImage m_frame;                          // 最近完成的画面
+    int m_frameCellSize;                     // 该画面合成时的格子大小
+    bool m_renderInFlight;                   // 是否有快照正在渲染
+    bool m_frameDeferred;                    // 渲染期间又有新的重绘请求
+    QRegion m_submittedRegion;               // 正在渲染的帧需要重绘的区域
+    QRegion m_submittedPieceRegion;          // 正在渲染的帧中方块覆盖的区域
+
+    // 布局：格子大小由控件尺寸决定，场地在控件内居中
+    int m_cellSize;                          // 格子大小（逻辑像素）
+    QPoint m_fieldOrigin;                    // 场地左上角在控件中的位置
+    QTimer m_resizeTimer;                    // 调整大小期间推迟重建
+    QSize fieldDimensions() const;           // 场地行列数
+    QRect layoutFieldRect() const;           // 按当前控件尺寸计算的场地区域
+
+    // 渲染节奏：信号只累积重绘区域，每个刷新周期最多提交一次
+    FramePacer* m_framePacer;
+    QRegion m_pendingRegion;                 // 下一帧需要重绘的区域
+    int m_fallOffset;                        // 本帧当前方块的下落像素偏移（平滑下落时为格内进度）
+    int currentFallOffset() const;           // 按引擎状态计算下落像素偏移
+
+    // 脏区域跟踪
+    QRegion m_pieceRegion;                   // 当前显示的画面中方块覆盖的区域
+    QRect blockRect(const Block& block, int offsetY = 0) const;  // 方块包围盒的像素区域（offsetY 为像素偏移）
+    QRegion pieceRegion() const;             // 当前方块和幽灵方块覆盖的区域
+    bool isGhostVisible() const;             // 是否绘制幽灵方块
+
+    // 消行动画和粒子效果：新增效果随下一帧快照提交，播放期间每帧重绘效果覆盖的行
+    LineClearEffect m_pendingLineClears[FrameSnapshot::MAX_LINE_CLEARS];
+    int m_pendingLineClearCount;
+    Block m_pendingLocks[FrameSnapshot::MAX_LOCKS];
+    int m_pendingLockCount;
+    int m_effectTop;                         // 播放中的效果覆盖的行范围 [top, bottom)，为空表示没有效果
+    int m_effectBottom;
+    qint64 m_effectEnd;                      // 最后一个效果的结束时间（纳秒）
+    void extendEffect(int top, int bottom, qint64 end);  // 合并新效果覆盖的行和结束时间
+    QRegion effectRegion() const;            // 播放中的效果覆盖的区域
+
+    // 输入延迟测量
+    QElapsedTimer m_clock;
+    qint64 m_activeInputTimestamp;           // 引擎正在处理的输入时间（GameClock 纳秒），-1 表示不在处理输入
+    qint64 m_inputTimestamp;                 // 尚未提交的最早一次输入时间（GameClock 纳秒），-1 表示无
+    void adoptInput();                       // 引擎请求重绘时，把正在处理的输入归入下一帧
+    qint64 m_displayedInputTimestamp;        // 待绘制画面反映的输入时间，-1 表示无
+    LatencyStats m_latencyStats;
+};
+
+// 单个方块预览界面的基类
+// 每种方块（以及空状态）的完整画面只渲染一次并缓存，之后每次绘制只贴一次图
+class BlockPreviewWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit BlockPreviewWidget(QWidget* parent = nullptr);
+
+    void setTheme(const Theme* theme);      // 切换主题，缓存画面随之重建
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+
+    void showBlock(const Block& block);     // 切换显示的方块，首次出现时渲染缓存画面
+    void invalidateFrames();                // 清空缓存画面
 
-    // 绘制方法
-    void drawGameField(QPainter& painter);   // 绘制游戏场地
-    void drawGhostBlock(QPainter& painter);  // 绘制幽灵方块
-    void drawCurrentBlock(QPainter& painter);// 绘制当前方块
+    // 绘制完整画面（背景、边框、文字和方块），block 无效时绘制空状态
+    virtual void renderFrame(QPainter& painter, const Block& block) = 0;
+    void drawBlockCentered(QPainter& painter, const Block& block);  // 在画面中居中绘制方块
+
+private:
+    void ensureFrame();                     // 当前方块的画面不存在时渲染
+    static CellSpriteCache& sharedSprites(); // 各预览窗格格子大小相同，共用一张图集
+
+    const Theme* m_theme;
+    QVector<QImage> m_frames;               // 缓存画面（按设备像素比渲染），下标 0 为空状态，其余为方块类型 + 1
+    int m_frameIndex;                       // 当前显示的画面
+    Block m_block;                          // 当前显示的方块
+    qreal m_frameDevicePixelRatio;          // 缓存画面对应的设备像素比
 };
 
 // 下一个方块预览界面
-class NextBlockWidget : public QWidget
+class NextBlockWidget : public BlockPreviewWidget
 {
     Q_OBJECT
 
@@ -32,27 +163,63 @@ public:
     explicit NextBlockWidget(QWidget* parent = nullptr);
     void setNextBlock(const Block& block);
 
+protected:
+    void renderFrame(QPainter& painter, const Block& block) override;
+
+private:
+    QStaticText m_title;
+};
+
+// 预览队列界面（显示下一个方块之后的多个方块）
+class NextQueueWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit NextQueueWidget(QWidget* parent = nullptr);
+    void setQueue(const QVector<Block>& blocks);
+    int getPreviewCount() const { return m_previewCount; }
+    void setTheme(const Theme* theme);      // 切换主题，缓存条带随之重建
+
 protected:
     void paintEvent(QPaintEvent* event) override;
 
 private:
-    Block m_nextBlock;
+    void renderStripSlot(const Block& block);  // 将方块绘制到缓存条带的对应槽位
+    void ensureStrip();                        // 确保队列中的方块都已绘制（设备像素比变化时重建）
+    void renderChrome();                       // 绘制背景、边框和标题
+
+    int m_previewCount;                 // 显示个数
+    int m_cellSize;                     // 格子大小
+    int m_slotWidth;                    // 槽位宽度
+    int m_slotHeight;                   // 槽位高度
+    QVector<Block> m_queue;             // 当前预览队列
+    QImage m_strip;                     // 缓存条带（按设备像素比渲染），每种方块占一个槽位
+    QVector<bool> m_stripReady;         // 槽位是否已绘制
+    qreal m_stripDevicePixelRatio;      // 缓存条带对应的设备像素比
+    QImage m_chrome;                    // 缓存的背景、边框和标题（与条带使用相同的设备像素比）
+    CellSpriteCache m_sprites;          // 按本窗格格子大小生成的图集
 };
 
 // 暂存方块预览界面
-class HoldBlockWidget : public QWidget
+class HoldBlockWidget : public BlockPreviewWidget
 {
     Q_OBJECT
 
 public:
     explicit HoldBlockWidget(QWidget* parent = nullptr);
     void setHoldBlock(const Block& block);
+    void setHoldKeyText(const QString& keys);   // 提示文字中的暂存按键（按键绑定变化时更新）
 
 protected:
-    void paintEvent(QPaintEvent* event) override;
+    void renderFrame(QPainter& painter, const Block& block) override;
 
 private:
-    Block m_holdBlock;
+    QFont m_hintFont;                       // 提示文字字体
+    QStaticText m_title;
+    QStaticText m_emptyText;
+    QStaticText m_emptyHint;
+    QStaticText m_heldHint;
 };
 
 #endif // GAMEWIDGET_H
@@ -0,0 +1,60 @@
+#include "LineClearAnimator.h"
+
+LineClearAnimator::LineClearAnimator()
+    : m_activeCount(0)
+{
+    clear();
+}
+
+void LineClearAnimator::start(const LineClearEffect& effect)
+{
+    // 优先使用空闲槽位，否则替换最早开始的效果
+    int slot = -1;
+    for (int i = 0; i < POOL_SIZE; ++i) {
+        if (!m_active[i]) {
+            slot = i;
+            break;
+        }
+        if (slot < 0 || m_pool[i].startTime < m_pool[slot].startTime) {
+            slot = i;
+        }
+    }
+
+    if (!m_active[slot]) {
+        m_active[slot] = true;
+        m_activeCount++;
+    }
+    m_pool[slot] = effect;
+}
+
+void LineClearAnimator::clear()
+{
+    for (int i = 0; i < POOL_SIZE; ++i) {
+        m_active[i] = false;
+    }
+    m_activeCount = 0;
+}
+
+void LineClearAnimator::draw(FieldRasterizer& rasterizer, qint64 now)
+{
+    for (int i = 0; i < POOL_SIZE && m_activeCount > 0; ++i) {
+        if (!m_active[i]) continue;
+
+        const LineClearEffect& effect = m_pool[i];
+        const float progress = effect.duration > 0
+            ? static_cast<float>(now - effect.startTime) / effect.duration
+            : 1.0f;
+
+        if (progress >= 1.0f) {
+            m_active[i] = false;
+            m_activeCount--;
+            continue;
+        }
+
+        if (progress < FLASH_PHASE) {
+            rasterizer.drawLineClear(effect.event, qMax(0.0f, progress) / FLASH_PHASE, 0.0f);
+        } else {
+            rasterizer.drawLineClear(effect.event, 1.0f, (progress - FLASH_PHASE) / (1.0f - FLASH_PHASE));
+        }
+    }
+}
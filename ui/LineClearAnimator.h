@@ -0,0 +1,41 @@
+#ifndef LINECLEARANIMATOR_H
+#define LINECLEARANIMATOR_H
+#include "LineClearEvent.h"
+#include "FieldRasterizer.h"
+
+// 一次消行效果：消行事件和播放时间
+struct LineClearEffect {
+    LineClearEvent event;
+    qint64 startTime;   // 开始时间（纳秒，与快照的 frameTime 为同一时钟）
+    qint64 duration;    // 持续时间（纳秒）
+
+    LineClearEffect() : startTime(0), duration(0) {}
+};
+
+// 消行动画
+// 引擎消行后立即继续运行，动画只根据事件中保存的行内容叠加在画面上：
+// 先闪烁变白，再向行中线收缩消失。效果保存在预分配的槽位中，播放期间不分配内存
+class LineClearAnimator
+{
+public:
+    static constexpr int POOL_SIZE = 8;              // 同时播放的最大效果数
+    static constexpr int DEFAULT_DURATION_MS = 250;  // 未配置消行等待时的动画时长
+    static constexpr float FLASH_PHASE = 0.4f;       // 闪烁阶段占总时长的比例
+
+    LineClearAnimator();
+
+    // 开始播放一个效果，槽位已满时替换最早开始的效果
+    void start(const LineClearEffect& effect);
+    void clear();
+    bool isActive() const { return m_activeCount > 0; }
+
+    // 把进行中的效果叠加到光栅化器的当前帧上，已结束的效果回收槽位
+    void draw(FieldRasterizer& rasterizer, qint64 now);
+
+private:
+    LineClearEffect m_pool[POOL_SIZE];
+    bool m_active[POOL_SIZE];
+    int m_activeCount;
+};
+
+#endif // LINECLEARANIMATOR_H
@@ -8,6 +8,7 @@
 // MainWindow 实现
 MainWindow::MainWindow(QWidget* parent)
     : QMainWindow(parent)
+    , m_isDailyChallenge(false)
     , m_stackedWidget(nullptr)
     , m_gameWidget(nullptr)
     , m_menuWidget(nullptr)
@@ -16,9 +17,18 @@ MainWindow::MainWindow(QWidget* parent)
     , m_levelLabel(nullptr)
     , m_linesLabel(nullptr)
     , m_startButton(nullptr)
+    , m_dailyButton(nullptr)
     , m_pauseButton(nullptr)
     , m_highScoresButton(nullptr)
+    , m_themeButton(nullptr)
+    , m_spectatorButton(nullptr)
     , m_nextBlockWidget(nullptr)
+    , m_nextQueueWidget(nullptr)
+    , m_spectatorScreen(nullptr)
+    , m_spectatorWidget(nullptr)
+    , m_spectatorDemo(nullptr)
+    , m_spectatorBackButton(nullptr)
+    , m_theme(nullptr)
     , m_gameScreen(nullptr)
     , m_mainGameLayout(nullptr)
     , m_gameAreaLayout(nullptr)
@@ -58,7 +68,7 @@ void MainWindow::initializeSystems()
 void MainWindow::setupUI()
 {
     setWindowTitle("俄罗斯方块");
-    setFixedSize(MAINWINDOW_FIXED_SIZEW, MAINWINDOW_FIXED_SIZEH);
+    resize(MAINWINDOW_FIXED_SIZEW, MAINWINDOW_FIXED_SIZEH);  // 初始大小，游戏区域随窗口缩放
 
     // 创建主堆叠窗口
     m_stackedWidget = new QStackedWidget(this);
@@ -73,13 +83,67 @@ void MainWindow::setupUI()
     // 创建暂停界面
     createPauseWidget();
 
+    // 创建观战界面
+    createSpectatorScreen();
+
     // 设置样式
     setupStyles();
 
+    // 加载主题
+    initializeThemes();
+
     // 连接基本UI信号槽（不依赖游戏引擎）
     setupBasicConnections();
 }
 
+void MainWindow::initializeThemes()
+{
+    // 所有主题在启动时解码一次并常驻内存，切换主题时只需在各自的格子大小下重建图集
+    m_themes.clear();
+    for (const QString& id : Theme::available()) {
+        if (Theme::get(id)) {
+            m_themes << id;
+        }
+    }
+
+    const Theme* theme = Theme::get(QString::fromStdString(THEME));
+    if (!theme) {
+        qWarning() << "Failed to load theme" << QString::fromStdString(THEME) << ", falling back to default";
+        theme = Theme::defaultTheme();
+    }
+    applyTheme(theme);
+}
+
+void MainWindow::applyTheme(const Theme* theme)
+{
+    m_theme = theme;
+
+    m_gameWidget->setTheme(theme);
+    m_nextBlockWidget->setTheme(theme);
+    m_nextQueueWidget->setTheme(theme);
+    m_holdBlockWidget->setTheme(theme);
+
+    if (m_themeButton) {
+        m_themeButton->setText(QString("主题: %1").arg(theme->getName()));
+    }
+}
+
+void MainWindow::switchTheme()
+{
+    if (m_themes.isEmpty()) return;
+
+    // 依次切换到下一个主题，并保存到配置文件
+    const int index = (m_themes.indexOf(m_theme->getId()) + 1) % m_themes.size();
+    const Theme* theme = Theme::get(m_themes[index]);
+    if (!theme) return;
+
+    applyTheme(theme);
+
+    GAME_CONFIG.setStringValue("Field", "theme", theme->getId().toStdString());
+    GAME_CONFIG.saveConfig();
+    GAME_CONFIG.updateConfigData();
+}
+
 void MainWindow::setupGameConnections()
 {
     if (!m_gameEngine) {
@@ -104,33 +168,12 @@ void MainWindow::setupGameConnections()
     // 连接输入处理器
     if (m_inputHandler) {
         connect(m_inputHandler.data(), &InputHandler::actionTriggered,
-                this, [this](InputHandler::GameAction action) {
+                this, [this](InputHandler::GameAction action, qint64 timestamp) {
                     if (!m_gameEngine) {
                         qDebug() << "ERROR: Game engine is null in input handler!";
                         return;
                     }
                     switch (action) {
-                    case InputHandler::ACTION_MOVE_LEFT:
-                        m_gameEngine->moveLeft();
-                        break;
-                    case InputHandler::ACTION_MOVE_RIGHT:
-                        m_gameEngine->moveRight();
-                        break;
-                    case InputHandler::ACTION_SOFT_DROP:
-                        m_gameEngine->softDrop();
-                        break;
-                    case InputHandler::ACTION_HARD_DROP:
-                        m_gameEngine->hardDrop();
-                        break;
-                    case InputHandler::ACTION_ROTATE_CW:
-                        m_gameEngine->rotateClockwise();
-                        break;
-                    case InputHandler::ACTION_ROTATE_CCW:
-                        m_gameEngine->rotateCounterClockwise();
-                        break;
-                    case InputHandler::ACTION_HOLD:
-                        m_gameEngine->holdBlock();
-                        break;
                     case InputHandler::ACTION_PAUSE:
                         if (m_gameEngine->getGameState() == GameEngine::STATE_RUNNING) {
                             m_gameEngine->pauseGame();
@@ -142,28 +185,30 @@ void MainWindow::setupGameConnections()
                         m_gameEngine->restartGame();
                         break;
                     default:
+                        // 游戏操作交给引擎排队，在模拟步进中按时间戳顺序应用；
+                        // 处理期间引擎请求了重绘时，该输入计入延迟统计
+                        if (m_gameWidget) m_gameWidget->beginInput(timestamp);
+                        m_gameEngine->queueInput(action, true, timestamp);
+                        if (m_gameWidget) m_gameWidget->endInput();
                         break;
                     }
                 });
-        // 连接引擎等级更新和输入延迟变化
-        connect(m_gameEngine.data(), &GameEngine::updateNewLevel, m_inputHandler.data(), &InputHandler::updateAutoRepeatDelay);
     }
 
+    // 按键绑定在配置文件中修改后更新按键说明
+    connect(m_inputHandler.data(), &InputHandler::bindingsChanged, this, &MainWindow::updateKeyHints);
+
     // 处理按键释放（特别是软下落释放）
     connect(m_inputHandler.data(), &InputHandler::actionReleased,
-            this, [this](InputHandler::GameAction action) {
+            this, [this](InputHandler::GameAction action, qint64 timestamp) {
                 if (!m_gameEngine) {
                     qDebug() << "ERROR: Game engine is null in input release handler!";
                     return;
                 }
-                switch (action) {
-                case InputHandler::ACTION_SOFT_DROP:
-                    m_gameEngine->stopSoftDrop();  // 停止软下落
-                    break;
-                default:
-                    // 其他动作的释放不需要特殊处理
-                    break;
-                }
+                // 释放同样按时间戳排队（横移的自动重复和软下落在此停止）
+                if (m_gameWidget) m_gameWidget->beginInput(timestamp);
+                m_gameEngine->queueInput(action, false, timestamp);
+                if (m_gameWidget) m_gameWidget->endInput();
             });
 }
 
@@ -173,8 +218,11 @@ void MainWindow::createMenuWidget()
     m_menuLayout = new QVBoxLayout(m_menuWidget);
 
     m_startButton = new QPushButton("开始游戏", this);
+    m_dailyButton = new QPushButton("每日挑战", this);
     m_highScoresButton = new QPushButton("高分榜", this);
     m_helpButton = new QPushButton("帮助", this);
+    m_themeButton = new QPushButton("主题", this);
+    m_spectatorButton = new QPushButton("观战演示", this);
     m_quitButton = new QPushButton("退出", this);
 
     // 设置菜单按钮样式
@@ -192,14 +240,20 @@ void MainWindow::createMenuWidget()
                           "}";
 
     m_startButton->setStyleSheet(buttonStyle);
+    m_dailyButton->setStyleSheet(buttonStyle);
     m_highScoresButton->setStyleSheet(buttonStyle);
     m_helpButton->setStyleSheet(buttonStyle);
+    m_themeButton->setStyleSheet(buttonStyle);
+    m_spectatorButton->setStyleSheet(buttonStyle);
     m_quitButton->setStyleSheet(buttonStyle);
 
     m_menuLayout->addStretch();
     m_menuLayout->addWidget(m_startButton);
+    m_menuLayout->addWidget(m_dailyButton);
     m_menuLayout->addWidget(m_highScoresButton);
     m_menuLayout->addWidget(m_helpButton);
+    m_menuLayout->addWidget(m_themeButton);
+    m_menuLayout->addWidget(m_spectatorButton);
     m_menuLayout->addWidget(m_quitButton);
     m_menuLayout->addStretch();
     m_menuLayout->setAlignment(Qt::AlignCenter);
@@ -226,14 +280,20 @@ void MainWindow::createGameScreen()
         qDebug() << "ERROR: Game engine is null when setting to game widget";
     }
 
-    m_gameAreaLayout->addWidget(m_gameWidget);
-    m_gameAreaLayout->setAlignment(m_gameWidget, Qt::AlignCenter);
+    m_gameAreaLayout->addWidget(m_gameWidget);  // 游戏区域自行居中，占满剩余空间
+
+    // 创建预览队列（位于游戏区域和信息面板之间）
+    m_nextQueueWidget = new NextQueueWidget(this);
+    if (m_gameEngine) {
+        m_nextQueueWidget->setQueue(m_gameEngine->getPreviewBlocks(m_nextQueueWidget->getPreviewCount()));
+    }
 
     // 创建右侧信息面板
     m_infoPanel = createInfoPanel();
 
     // 添加到主布局
-    m_mainGameLayout->addWidget(m_gameArea);
+    m_mainGameLayout->addWidget(m_gameArea, 1);
+    m_mainGameLayout->addWidget(m_nextQueueWidget, 0, Qt::AlignTop);
     m_mainGameLayout->addWidget(m_infoPanel);
 
     // 设置背景
@@ -285,16 +345,9 @@ QWidget* MainWindow::createInfoPanel()
     m_controlsLabel = new QLabel("控制说明:", this);
     m_controlsLabel->setStyleSheet("QLabel { color: white; font-size: 14px; font-weight: bold; padding: 5px; margin-top: 20px; }");
 
-    m_controlsText = new QLabel(
-        "←→或AD : 左右移动\n"
-        "↑或W : 顺时针旋转\n"
-        "Z : 逆时针旋转\n"
-        "↓或S : 软降落\n"
-        "空格 : 硬降落\n"
-        "C : 暂存方块\n"
-        "P : 暂停/继续\n"
-        "R : 重新开始", this);
+    m_controlsText = new QLabel(this);
     m_controlsText->setStyleSheet("QLabel { color: lightgray; font-size: 12px; padding: 5px; line-height: 1.5; }");
+    updateKeyHints();
 
     // 添加到信息面板布局
     m_infoPanelLayout->addWidget(m_scoreLabel);
@@ -354,6 +407,40 @@ void MainWindow::createPauseWidget()
     m_stackedWidget->addWidget(m_pauseWidget);
 }
 
+void MainWindow::createSpectatorScreen()
+{
+    m_spectatorScreen = new QWidget(this);
+    QVBoxLayout* layout = new QVBoxLayout(m_spectatorScreen);
+
+    // 观战墙占满界面，对局只在显示观战界面时运行
+    m_spectatorWidget = new SpectatorWidget(m_spectatorScreen);
+    m_spectatorDemo = new SpectatorDemo(m_spectatorWidget, this);
+
+    m_spectatorBackButton = new QPushButton("返回主菜单", m_spectatorScreen);
+    m_spectatorBackButton->setStyleSheet("QPushButton { "
+                                         "background-color: #e74c3c; "
+                                         "color: white; "
+                                         "border: none; "
+                                         "padding: 6px; "
+                                         "font-size: 14px; "
+                                         "border-radius: 5px; "
+                                         "}"
+                                         "QPushButton:hover { "
+                                         "background-color: #c0392b; "
+                                         "}");
+
+    layout->addWidget(m_spectatorWidget, 1);
+    layout->addWidget(m_spectatorBackButton, 0, Qt::AlignHCenter);
+
+    m_stackedWidget->addWidget(m_spectatorScreen);
+}
+
+void MainWindow::showSpectatorDemo()
+{
+    m_spectatorDemo->start();
+    m_stackedWidget->setCurrentWidget(m_spectatorScreen);
+}
+
 void MainWindow::setupStyles()
 {
     // 设置主窗口背景
@@ -369,6 +456,10 @@ void MainWindow::setupBasicConnections()
         qDebug() << "ERROR: Start button is null!";
     }
 
+    if (m_dailyButton) {
+        connect(m_dailyButton, &QPushButton::clicked, this, &MainWindow::startDailyChallenge);
+    }
+
     if (m_highScoresButton) {
         connect(m_highScoresButton, &QPushButton::clicked, this, &MainWindow::showHighScores);
     }
@@ -377,6 +468,21 @@ void MainWindow::setupBasicConnections()
         connect(m_helpButton, &QPushButton::clicked, this, &MainWindow::showHelp);
     }
 
+    if (m_themeButton) {
+        connect(m_themeButton, &QPushButton::clicked, this, &MainWindow::switchTheme);
+    }
+
+    if (m_spectatorButton) {
+        connect(m_spectatorButton, &QPushButton::clicked, this, &MainWindow::showSpectatorDemo);
+    }
+
+    if (m_spectatorBackButton) {
+        connect(m_spectatorBackButton, &QPushButton::clicked, this, [this]() {
+            m_spectatorDemo->stop();
+            m_stackedWidget->setCurrentWidget(m_menuWidget);
+        });
+    }
+
     if (m_quitButton) {
         connect(m_quitButton, &QPushButton::clicked, this, &QApplication::quit);
     }
@@ -406,6 +512,9 @@ void MainWindow::onNextBlockChanged()
     if (m_nextBlockWidget && m_gameEngine) {
         m_nextBlockWidget->setNextBlock(m_gameEngine->getNextBlock());
     }
+    if (m_nextQueueWidget && m_gameEngine) {
+        m_nextQueueWidget->setQueue(m_gameEngine->getPreviewBlocks(m_nextQueueWidget->getPreviewCount()));
+    }
 }
 
 // 处理Hold方块变化的槽函数
@@ -419,14 +528,27 @@ void MainWindow::onHoldBlockChanged()
 // 系统槽函数
 void MainWindow::keyPressEvent(QKeyEvent* event)
 {
-    if (!event->isAutoRepeat() && !m_inputHandler->processKeyEvent(event)) {
+    // F3 切换性能浮层
+    if (event->key() == Qt::Key_F3) {
+        if (!event->isAutoRepeat() && m_gameWidget) {
+            m_gameWidget->togglePerfOverlay();
+        }
+        return;
+    }
+
+    // 收到事件时取时间戳，引擎按它排序输入，延迟统计也从它开始计算
+    const qint64 timestamp = GameClock::now();
+
+    if (!event->isAutoRepeat() && !m_inputHandler->processKeyEvent(event, timestamp)) {
         QMainWindow::keyPressEvent(event);
     }
 }
 
 void MainWindow::keyReleaseEvent(QKeyEvent* event)
 {
-    if (!event->isAutoRepeat() && !m_inputHandler->processKeyEvent(event)) {
+    const qint64 timestamp = GameClock::now();
+
+    if (!event->isAutoRepeat() && !m_inputHandler->processKeyEvent(event, timestamp)) {
         QMainWindow::keyReleaseEvent(event);
     }
 }
@@ -473,12 +595,21 @@ void MainWindow::handleGameOver()
         m_scoreManager->addScore(stats.score, stats.level, stats.linesCleared);
     }
 
+    QString message = QString("游戏结束!\n得分: %1\n等级: %2\n消除行数: %3")
+                          .arg(stats.score)
+                          .arg(stats.level)
+                          .arg(stats.linesCleared);
+
+    // 每日挑战成绩单独记录到当天种子的排行榜
+    if (m_isDailyChallenge && m_scoreManager) {
+        const ScoreManager::DailyKey key = dailyKey(stats.seed);
+        int rank = m_scoreManager->addDailyScore(key, stats.score, stats.level, stats.linesCleared);
+        int players = m_scoreManager->getDailyPlayerCount(key);
+        message += QString("\n\n每日挑战排名: %1 / %2").arg(rank).arg(players);
+    }
+
     // 显示游戏结束对话框
-    QMessageBox::information(this, "游戏结束",
-                             QString("游戏结束!\n得分: %1\n等级: %2\n消除行数: %3")
-                                 .arg(stats.score)
-                                 .arg(stats.level)
-                                 .arg(stats.linesCleared));
+    QMessageBox::information(this, "游戏结束", message);
 
     // 返回主菜单
     if (m_stackedWidget) {
@@ -506,6 +637,21 @@ void MainWindow::startNewGame()
         return;
     }
 
+    m_isDailyChallenge = false;
+    m_gameEngine->clearSeed();
+    m_gameEngine->startGame();
+}
+
+void MainWindow::startDailyChallenge()
+{
+    if (!m_gameEngine) {
+        qDebug() << "ERROR: Game engine is null!";
+        return;
+    }
+
+    // 同一天所有玩家使用相同的方块序列
+    m_isDailyChallenge = true;
+    m_gameEngine->setSeed(GameEngine::dailySeed(QDate::currentDate()));
     m_gameEngine->startGame();
 }
 
@@ -525,21 +671,79 @@ void MainWindow::showHighScores()
                          .arg(score.date.toString("yyyy-MM-dd"));
     }
 
+    // 今日挑战排行榜
+    quint64 seed = GameEngine::dailySeed(QDate::currentDate());
+    const ScoreManager::DailyKey key = dailyKey(seed);
+    QVector<ScoreManager::HighScore> dailyScores = m_scoreManager->getDailyHighScores(key, MAX_HIGH_SCORES);
+    scoreText += QString("今日挑战 (%1, %2, %3):\n\n")
+                     .arg(QDate::currentDate().toString("yyyy-MM-dd"), key.mode, key.pieceSet);
+    if (dailyScores.isEmpty()) {
+        scoreText += "暂无成绩\n";
+    }
+    for (int i = 0; i < dailyScores.size(); ++i) {
+        const auto& score = dailyScores[i];
+        scoreText += QString("%1. %2  分数：%3\n")
+                         .arg(i + 1)
+                         .arg(score.playerName)
+                         .arg(score.score);
+    }
+
     QMessageBox::information(this, "高分榜", scoreText);
 }
 
+ScoreManager::DailyKey MainWindow::dailyKey(quint64 seed) const
+{
+    // 随机模式和方块集合取自引擎实际使用的设置，不同规则下的成绩分开排名
+    const BlockFactory::RandomizerState state = m_gameEngine->getRandomizerState();
+
+    ScoreManager::DailyKey key;
+    key.seed = seed;
+    key.mode = QString::fromLatin1(Randomizer::modeName(state.mode));
+    key.pieceSet = state.pieceSet;
+    return key;
+}
+
+QString MainWindow::controlsDescription() const
+{
+    if (!m_inputHandler) return QString();
+
+    const InputHandler* input = m_inputHandler.data();
+    return QString("%1 : 左移\n"
+                   "%2 : 右移\n"
+                   "%3 : 顺时针旋转\n"
+                   "%4 : 逆时针旋转\n"
+                   "%5 : 软降落\n"
+                   "%6 : 硬降落\n"
+                   "%7 : 暂存方块\n"
+                   "%8 : 暂停/继续\n"
+                   "%9 : 重新开始")
+        .arg(input->keyText(InputHandler::ACTION_MOVE_LEFT),
+             input->keyText(InputHandler::ACTION_MOVE_RIGHT),
+             input->keyText(InputHandler::ACTION_ROTATE_CW),
+             input->keyText(InputHandler::ACTION_ROTATE_CCW),
+             input->keyText(InputHandler::ACTION_SOFT_DROP),
+             input->keyText(InputHandler::ACTION_HARD_DROP),
+             input->keyText(InputHandler::ACTION_HOLD),
+             input->keyText(InputHandler::ACTION_PAUSE),
+             input->keyText(InputHandler::ACTION_RESTART));
+}
+
+void MainWindow::updateKeyHints()
+{
+    if (!m_inputHandler) return;
+
+    if (m_controlsText) {
+        m_controlsText->setText(controlsDescription());
+    }
+    if (m_holdBlockWidget) {
+        m_holdBlockWidget->setHoldKeyText(m_inputHandler->keyText(InputHandler::ACTION_HOLD));
+    }
+}
+
 void MainWindow::showHelp()
 {
     QString helpText =
-        "游戏控制:\n"
-        "←或A →或D : 左右移动\n"
-        "↑或W : 顺时针旋转\n"
-        "Z : 逆时针旋转\n"
-        "↓或S : 软降落\n"
-        "空格 : 硬降落\n"
-        "C : 暂存方块\n"
-        "P : 暂停/继续\n"
-        "R : 重新开始\n\n"
+        "游戏控制:\n" + controlsDescription() + "\n\n"
         "游戏规则:\n"
         "- 消除完整的行来获得分数\n"
         "- 等级越高，方块下落速度越快\n"
@@ -13,6 +13,8 @@
 #include "InputHandler.h"
 #include "ScoreManager.h"
 #include "GameWidget.h"
+#include "SpectatorWidget.h"
+#include "SpectatorDemo.h"
 
 class GameEngine;
 
@@ -35,11 +37,16 @@ private slots:
     void onGameStatsUpdated(const GameStats& stats);
     // 游戏控制事件
     void startNewGame();
+    void startDailyChallenge();
     void showHighScores();
     void showHelp();
+    void switchTheme();
+    void showSpectatorDemo();
     // 游戏中事件
     void onNextBlockChanged();
     void onHoldBlockChanged();
+    // 按键绑定变化后更新界面上的按键说明
+    void updateKeyHints();
 
 private:
     void setupUI();
@@ -49,6 +56,8 @@ private:
     void createGameScreen();
     // 创建暂停界面
     void createPauseWidget();
+    // 创建观战界面
+    void createSpectatorScreen();
     // 设置样式
     void setupStyles();
     // 创建右侧信息面板
@@ -57,12 +66,19 @@ private:
     void setupBasicConnections();
     void initializeSystems();
     void handleGameOver();
+    void initializeThemes();                // 预先加载所有主题，切换时不再解码图集
+    void applyTheme(const Theme* theme);
+    QString controlsDescription() const;    // 按当前按键绑定生成的控制说明
+    ScoreManager::DailyKey dailyKey(quint64 seed) const;  // 每日挑战排行榜条件（引擎当前的随机模式和方块集合）
 
     // 核心系统组件
     QScopedPointer<GameEngine> m_gameEngine;
     QScopedPointer<InputHandler> m_inputHandler;
     QScopedPointer<ScoreManager> m_scoreManager;
 
+    // 每日挑战
+    bool m_isDailyChallenge;         // 当前是否为每日挑战
+
     // UI组件
     QStackedWidget* m_stackedWidget;
     GameWidget* m_gameWidget;
@@ -78,18 +94,32 @@ private:
     QLabel* m_controlsLabel;
     QLabel* m_controlsText;
     QPushButton* m_startButton;
+    QPushButton* m_dailyButton;
     QPushButton* m_highScoresButton;
     QPushButton* m_helpButton;
+    QPushButton* m_themeButton;
+    QPushButton* m_spectatorButton;
     QPushButton* m_quitButton;
     QPushButton* m_pauseButton;
     QPushButton* m_menuButton;
 
     // 预览组件
     NextBlockWidget* m_nextBlockWidget;
+    NextQueueWidget* m_nextQueueWidget;
 
     // 暂存组件
     HoldBlockWidget* m_holdBlockWidget;
 
+    // 观战演示
+    QWidget* m_spectatorScreen;
+    SpectatorWidget* m_spectatorWidget;
+    SpectatorDemo* m_spectatorDemo;
+    QPushButton* m_spectatorBackButton;
+
+    // 主题
+    QStringList m_themes;            // 可选主题
+    const Theme* m_theme;            // 当前主题
+
     // 布局相关成员
     QWidget* m_gameScreen;           // 游戏界面主窗口
     QWidget* m_gameArea;             // 游戏区域
@@ -0,0 +1,179 @@
+#include <QColor>
+#include <QDebug>
+#include "ParticleSystem.h"
+
+namespace {
+
+constexpr float GRAVITY = 40.0f;            // 重力加速度（格/秒²）
+constexpr int LOCK_SPARKS_PER_CELL = 3;     // 锁定时每个格子的火花数
+constexpr int DEBRIS_PER_CELL = 4;          // 消行时每个格子的碎片数
+constexpr int OVER_BUDGET_FRAMES = 3;       // 连续超出预算多少帧后降级
+constexpr int UNDER_BUDGET_FRAMES = 120;    // 连续远低于预算多少帧后恢复一级
+constexpr float MIN_SPAWN_SCALE = 0.125f;   // 低于该比例时停止生成
+
+// 颜色向白色混合，火花比方块本身更亮
+quint32 lighten(QRgb color)
+{
+    const int r = (qRed(color) + 255) / 2;
+    const int g = (qGreen(color) + 255) / 2;
+    const int b = (qBlue(color) + 255) / 2;
+    return qRgba(r, g, b, 255);
+}
+
+} // namespace
+
+ParticleSystem::ParticleSystem()
+    : m_count(0)
+    , m_random(0x5eed)
+    , m_spawnScale(1.0f)
+    , m_spawnRemainder(0.0f)
+    , m_overBudgetFrames(0)
+    , m_underBudgetFrames(0)
+    , m_dropped(0)
+{
+}
+
+void ParticleSystem::spawnLockSparks(const Block& block)
+{
+    if (!block.isValid()) return;
+
+    const quint32 color = lighten(block.getColor().rgba());
+    const PieceSet::Rotation& rotation = block.getRotationData();
+    const Position position = block.getPosition();
+
+    // 火花从每个格子的底边向上溅起
+    for (int i = 0; i < rotation.cellCount; ++i) {
+        const float cellX = static_cast<float>(position.x + rotation.cells[i].x);
+        const float cellBottom = static_cast<float>(position.y + rotation.cells[i].y + 1);
+
+        const int count = scaledCount(LOCK_SPARKS_PER_CELL);
+        for (int n = 0; n < count; ++n) {
+            spawn(cellX + randomUnit(), cellBottom,
+                  randomRange(-3.0f, 3.0f), randomRange(-7.0f, -2.0f),
+                  randomRange(0.25f, 0.45f), color);
+        }
+    }
+}
+
+void ParticleSystem::spawnLineDebris(const LineClearEvent& event)
+{
+    // 被消除的每个格子碎裂成若干碎片，向上抛出后下落
+    for (int row = 0; row < event.rowCount; ++row) {
+        const float y = static_cast<float>(event.rows[row]);
+
+        for (int x = 0; x < event.width; ++x) {
+            const QRgb rgba = event.cells[row][x];
+            if (qAlpha(rgba) == 0) continue;
+
+            const quint32 color = rgba | 0xff000000u;
+            const int count = scaledCount(DEBRIS_PER_CELL);
+            for (int n = 0; n < count; ++n) {
+                spawn(x + randomUnit(), y + randomUnit(),
+                      randomRange(-6.0f, 6.0f), randomRange(-10.0f, -3.0f),
+                      randomRange(0.4f, MAX_LIFETIME_MS / 1000.0f), color);
+            }
+        }
+    }
+}
+
+void ParticleSystem::update(float dt)
+{
+    const int count = m_count;
+
+    // 每个属性单独一个循环，便于自动向量化
+    for (int i = 0; i < count; ++i) {
+        m_vy[i] += GRAVITY * dt;
+    }
+    for (int i = 0; i < count; ++i) {
+        m_x[i] += m_vx[i] * dt;
+    }
+    for (int i = 0; i < count; ++i) {
+        m_y[i] += m_vy[i] * dt;
+    }
+    for (int i = 0; i < count; ++i) {
+        m_life[i] -= dt;
+    }
+
+    // 回收寿命结束的粒子：用末尾的粒子填补空位，保持数组紧凑
+    int i = 0;
+    while (i < m_count) {
+        if (m_life[i] > 0.0f) {
+            ++i;
+            continue;
+        }
+
+        const int last = --m_count;
+        m_x[i] = m_x[last];
+        m_y[i] = m_y[last];
+        m_vx[i] = m_vx[last];
+        m_vy[i] = m_vy[last];
+        m_life[i] = m_life[last];
+        m_inverseLifetime[i] = m_inverseLifetime[last];
+        m_color[i] = m_color[last];
+    }
+}
+
+void ParticleSystem::clear()
+{
+    m_count = 0;
+}
+
+void ParticleSystem::reportFrameCost(qint64 costNs)
+{
+    if (costNs > FRAME_BUDGET_NS) {
+        m_underBudgetFrames = 0;
+        if (++m_overBudgetFrames < OVER_BUDGET_FRAMES) return;
+
+        // 降级：生成数量减半，同时丢弃一半现有粒子，立即减轻后续帧的负担
+        m_overBudgetFrames = 0;
+        m_spawnScale = m_spawnScale * 0.5f < MIN_SPAWN_SCALE ? 0.0f : m_spawnScale * 0.5f;
+        m_dropped += m_count - m_count / 2;
+        m_count /= 2;
+        qDebug() << "Particle budget exceeded, spawn scale reduced to" << m_spawnScale;
+    } else if (costNs < FRAME_BUDGET_NS / 4) {
+        m_overBudgetFrames = 0;
+        if (m_spawnScale >= 1.0f || ++m_underBudgetFrames < UNDER_BUDGET_FRAMES) return;
+
+        // 恢复一级
+        m_underBudgetFrames = 0;
+        m_spawnScale = m_spawnScale <= 0.0f ? MIN_SPAWN_SCALE : qMin(1.0f, m_spawnScale * 2.0f);
+    } else {
+        m_overBudgetFrames = 0;
+        m_underBudgetFrames = 0;
+    }
+}
+
+void ParticleSystem::spawn(float x, float y, float vx, float vy, float lifetime, quint32 color)
+{
+    // 达到上限时丢弃新粒子，不影响已有粒子
+    if (m_count >= CAPACITY) {
+        m_dropped++;
+        return;
+    }
+
+    const int i = m_count++;
+    m_x[i] = x;
+    m_y[i] = y;
+    m_vx[i] = vx;
+    m_vy[i] = vy;
+    m_life[i] = lifetime;
+    m_inverseLifetime[i] = 1.0f / lifetime;
+    m_color[i] = color;
+}
+
+int ParticleSystem::scaledCount(int count)
+{
+    if (m_spawnScale >= 1.0f) return count;
+
+    const float scaled = count * m_spawnScale + m_spawnRemainder;
+    const int result = static_cast<int>(scaled);
+    m_spawnRemainder = scaled - result;
+    m_dropped += count - result;
+    return result;
+}
+
+float ParticleSystem::randomUnit()
+{
+    // 取高 24 位，正好填满 float 的尾数
+    return static_cast<float>(m_random() >> 40) * (1.0f / 16777216.0f);
+}
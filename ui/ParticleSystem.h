@@ -0,0 +1,72 @@
+#ifndef PARTICLESYSTEM_H
+#define PARTICLESYSTEM_H
+#include <QtGlobal>
+#include "Block.h"
+#include "LineClearEvent.h"
+#include "RandomGenerator.h"
+
+// 粒子系统（锁定火花、消行碎片）
+// 固定容量，位置、速度、寿命和颜色分别存放在独立数组中（结构数组），
+// 每个属性按批次更新，循环体简单，编译器可自动向量化；坐标单位为格，时间单位为秒
+//
+// 降级策略：每帧报告粒子阶段的耗时，连续超出预算时减半生成数量并丢弃一半现有粒子，
+// 生成比例降为 0 后不再生成；持续远低于预算时逐步恢复
+class ParticleSystem
+{
+public:
+    static constexpr int CAPACITY = 2048;             // 粒子上限，达到上限时新粒子被丢弃
+    static constexpr int MAX_LIFETIME_MS = 700;       // 粒子最长寿命
+    static constexpr qint64 FRAME_BUDGET_NS = 1000000; // 每帧粒子更新和绘制的时间预算
+
+    ParticleSystem();
+
+    // 生成效果（数量按当前生成比例缩放）
+    void spawnLockSparks(const Block& block);         // 锁定方块底部的火花
+    void spawnLineDebris(const LineClearEvent& event); // 被消除的格子飞散的碎片
+
+    // 按时间步长批量更新，回收寿命结束的粒子
+    void update(float dt);
+    void clear();
+
+    // 报告本帧粒子阶段的耗时，据此调整生成比例
+    void reportFrameCost(qint64 costNs);
+
+    // 结构数组只读访问，供光栅化器一次性绘制
+    int getCount() const { return m_count; }
+    const float* getX() const { return m_x; }
+    const float* getY() const { return m_y; }
+    const float* getLife() const { return m_life; }
+    const float* getInverseLifetime() const { return m_inverseLifetime; }
+    const quint32* getColor() const { return m_color; }
+
+    // 统计
+    float getSpawnScale() const { return m_spawnScale; }
+    quint64 getDroppedCount() const { return m_dropped; }
+
+private:
+    void spawn(float x, float y, float vx, float vy, float lifetime, quint32 color);
+    int scaledCount(int count);         // 按生成比例缩放数量（小数部分累积到下一次）
+    float randomUnit();                 // [0, 1) 均匀随机数
+    float randomRange(float low, float high) { return low + (high - low) * randomUnit(); }
+
+    // 结构数组
+    float m_x[CAPACITY];
+    float m_y[CAPACITY];
+    float m_vx[CAPACITY];
+    float m_vy[CAPACITY];
+    float m_life[CAPACITY];             // 剩余寿命（秒）
+    float m_inverseLifetime[CAPACITY];  // 1 / 总寿命，用于计算透明度
+    quint32 m_color[CAPACITY];          // 不透明 ARGB 颜色
+    int m_count;
+
+    RandomGenerator m_random;
+
+    // 降级
+    float m_spawnScale;                 // 生成比例 0-1
+    float m_spawnRemainder;             // 缩放后累积的小数部分
+    int m_overBudgetFrames;             // 连续超出预算的帧数
+    int m_underBudgetFrames;            // 连续远低于预算的帧数
+    quint64 m_dropped;                  // 因容量或降级未生成的粒子数
+};
+
+#endif // PARTICLESYSTEM_H
@@ -0,0 +1,103 @@
+#include <QPainter>
+#include <QFontMetrics>
+#include "PerfOverlay.h"
+
+PerfOverlay::PerfOverlay(const FramePacer* framePacer, QWidget* parent)
+    : QWidget(parent)
+    , m_framePacer(framePacer)
+    , m_font(QFont("Consolas", 9))
+    , m_lastRefreshNs(0)
+    , m_lastRepaints(0)
+    , m_lastSignals(0)
+    , m_lastDropped(0)
+{
+    // 只显示文字，不拦截鼠标事件
+    setAttribute(Qt::WA_TransparentForMouseEvents);
+    m_font.setStyleHint(QFont::Monospace);
+
+    m_refreshTimer.setInterval(REFRESH_INTERVAL_MS);
+    connect(&m_refreshTimer, &QTimer::timeout, this, &PerfOverlay::refresh);
+
+    m_clock.start();
+}
+
+void PerfOverlay::showEvent(QShowEvent* event)
+{
+    QWidget::showEvent(event);
+
+    // 从显示时开始计算每秒次数
+    m_lastRefreshNs = m_clock.nsecsElapsed();
+    m_lastRepaints = PERF_STATS.getCount(PerfStats::COUNTER_REPAINT);
+    m_lastSignals = PERF_STATS.getCount(PerfStats::COUNTER_SIGNAL);
+    m_lastDropped = m_framePacer ? m_framePacer->getStats().dropped : 0;
+
+    refresh();
+    m_refreshTimer.start();
+}
+
+void PerfOverlay::hideEvent(QHideEvent* event)
+{
+    QWidget::hideEvent(event);
+    m_refreshTimer.stop();
+}
+
+QString PerfOverlay::formatSummary(const QString& label, const PerfStats::Summary& summary)
+{
+    return QString("%1 p50 %2  p99 %3  max %4 ms")
+        .arg(label)
+        .arg(summary.p50 / 1e6, 6, 'f', 2)
+        .arg(summary.p99 / 1e6, 6, 'f', 2)
+        .arg(summary.max / 1e6, 6, 'f', 2);
+}
+
+void PerfOverlay::refresh()
+{
+    const qint64 now = m_clock.nsecsElapsed();
+    const double seconds = qMax<qint64>(1, now - m_lastRefreshNs) / 1e9;
+
+    const quint64 repaints = PERF_STATS.getCount(PerfStats::COUNTER_REPAINT);
+    const quint64 signalCount = PERF_STATS.getCount(PerfStats::COUNTER_SIGNAL);
+    const quint64 dropped = m_framePacer ? m_framePacer->getStats().dropped : 0;
+
+    m_lines.clear();
+    m_lines << formatSummary("绘制", PERF_STATS.summarize(PerfStats::CHANNEL_PAINT));
+    m_lines << formatSummary("合成", PERF_STATS.summarize(PerfStats::CHANNEL_RENDER));
+    m_lines << formatSummary("更新", PERF_STATS.summarize(PerfStats::CHANNEL_TICK));
+    m_lines << formatSummary("抖动", PERF_STATS.summarize(PerfStats::CHANNEL_TICK_JITTER));
+    m_lines << QString("重绘 %1/s  信号 %2/s  丢帧 %3/s")
+                   .arg((repaints - m_lastRepaints) / seconds, 0, 'f', 0)
+                   .arg((signalCount - m_lastSignals) / seconds, 0, 'f', 0)
+                   .arg((dropped - m_lastDropped) / seconds, 0, 'f', 0);
+
+    m_lastRefreshNs = now;
+    m_lastRepaints = repaints;
+    m_lastSignals = signalCount;
+    m_lastDropped = dropped;
+
+    // 按文字调整大小
+    const QFontMetrics metrics(m_font);
+    int width = 0;
+    for (const QString& line : std::as_const(m_lines)) {
+        width = qMax(width, metrics.horizontalAdvance(line));
+    }
+    resize(width + 12, metrics.lineSpacing() * m_lines.size() + 8);
+
+    update();
+}
+
+void PerfOverlay::paintEvent(QPaintEvent* event)
+{
+    Q_UNUSED(event)
+
+    QPainter painter(this);
+    painter.fillRect(rect(), QColor(0, 0, 0, 180));
+    painter.setFont(m_font);
+    painter.setPen(QColor(0, 255, 128));
+
+    const QFontMetrics metrics(m_font);
+    int y = 4 + metrics.ascent();
+    for (const QString& line : std::as_const(m_lines)) {
+        painter.drawText(6, y, line);
+        y += metrics.lineSpacing();
+    }
+}
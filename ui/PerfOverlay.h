@@ -0,0 +1,47 @@
+#ifndef PERFOVERLAY_H
+#define PERFOVERLAY_H
+#include <QWidget>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QFont>
+#include "PerfStats.h"
+#include "FramePacer.h"
+
+// 性能浮层：最近的绘制、合成和游戏更新耗时分位数（p50/p99/max），计时器抖动，
+// 以及每秒重绘次数、收到的引擎信号数和丢帧数
+// 采样由 PerfStats 常开收集，浮层只在显示时每 REFRESH_INTERVAL_MS 读取一次
+class PerfOverlay : public QWidget
+{
+    Q_OBJECT
+
+public:
+    static constexpr int REFRESH_INTERVAL_MS = 500;  // 文字刷新间隔
+
+    explicit PerfOverlay(const FramePacer* framePacer, QWidget* parent = nullptr);
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    void showEvent(QShowEvent* event) override;
+    void hideEvent(QHideEvent* event) override;
+
+private slots:
+    void refresh();                         // 读取统计并更新文字
+
+private:
+    static QString formatSummary(const QString& label, const PerfStats::Summary& summary);
+
+    const FramePacer* m_framePacer;
+    QTimer m_refreshTimer;
+    QElapsedTimer m_clock;
+    QFont m_font;
+    QStringList m_lines;                    // 当前显示的文字
+
+    // 上次刷新时的计数，用于计算每秒次数
+    qint64 m_lastRefreshNs;
+    quint64 m_lastRepaints;
+    quint64 m_lastSignals;
+    quint64 m_lastDropped;
+};
+
+#endif // PERFOVERLAY_H
@@ -0,0 +1,64 @@
+#include <QElapsedTimer>
+#include "RenderWorker.h"
+#include "PerfStats.h"
+
+RenderWorker::RenderWorker(QObject* parent)
+    : QObject(parent)
+    , m_lastFrameTime(0)
+{
+}
+
+void RenderWorker::render(const FrameSnapshot& snapshot)
+{
+    QElapsedTimer renderTimer;
+    renderTimer.start();
+
+    m_rasterizer.setGeometry(snapshot.cellSize, snapshot.devicePixelRatio);
+    m_rasterizer.setTheme(snapshot.theme);
+
+    for (int i = 0; i < snapshot.lineClearCount; ++i) {
+        m_lineClearAnimator.start(snapshot.lineClears[i]);
+    }
+
+    // 已有粒子按两帧之间的真实时间推进（与界面线程的效果结束时间一致），新生成的粒子从本帧开始
+    const float dt = m_particles.getCount() > 0 ? qMax<qint64>(0, snapshot.frameTime - m_lastFrameTime) / 1e9f : 0.0f;
+    m_lastFrameTime = snapshot.frameTime;
+
+    QElapsedTimer particleTimer;
+    particleTimer.start();
+    if (PARTICLE_EFFECTS) {
+        for (int i = 0; i < snapshot.lockCount; ++i) {
+            m_particles.spawnLockSparks(snapshot.locks[i]);
+        }
+        for (int i = 0; i < snapshot.lineClearCount; ++i) {
+            m_particles.spawnLineDebris(snapshot.lineClears[i].event);
+        }
+    }
+    qint64 particleCost = particleTimer.nsecsElapsed();
+
+    const QImage& frame = m_rasterizer.render(snapshot.field,
+                                              &snapshot.current,
+                                              snapshot.fallOffset,
+                                              &snapshot.ghost);
+
+    // 消行效果叠加在合成后的帧上，下一帧由光栅化器自动擦除
+    if (m_lineClearAnimator.isActive()) {
+        m_lineClearAnimator.draw(m_rasterizer, snapshot.frameTime);
+    }
+
+    // 粒子批量更新后一次性绘制，生成、更新和绘制的耗时计入降级策略
+    if (m_particles.getCount() > 0) {
+        particleTimer.restart();
+        m_particles.update(dt);
+        m_rasterizer.drawParticles(m_particles);
+        particleCost += particleTimer.nsecsElapsed();
+    }
+    if (PARTICLE_EFFECTS) {
+        m_particles.reportFrameCost(particleCost);
+    }
+
+    PERF_STATS.record(PerfStats::CHANNEL_RENDER, renderTimer.nsecsElapsed());
+
+    // 发出的图像与光栅化器共享数据，下一次合成写入时会自动分离，界面线程持有的画面不受影响
+    emit frameReady(frame, snapshot.cellSize, snapshot.inputTimestamp);
+}
@@ -0,0 +1,59 @@
+#ifndef RENDERWORKER_H
+#define RENDERWORKER_H
+#include <QObject>
+#include <QImage>
+#include <QMetaType>
+#include "GameField.h"
+#include "Block.h"
+#include "FieldRasterizer.h"
+#include "LineClearAnimator.h"
+#include "ParticleSystem.h"
+
+// 一帧画面所需的引擎状态快照（按值复制，渲染线程只读）
+struct FrameSnapshot {
+    static constexpr int MAX_LINE_CLEARS = 2;  // 一帧内新增的消行效果上限
+    static constexpr int MAX_LOCKS = 2;        // 一帧内新增的锁定效果上限
+
+    GameField field;            // 场地（隐式共享，复制代价很小）
+    Block current;              // 当前方块，无效时不绘制
+    Block ghost;                // 幽灵方块，无效时不绘制
+    float fallOffset;           // 当前方块的下落偏移（格）
+    int cellSize;               // 格子大小（逻辑像素）
+    qreal devicePixelRatio;     // 设备像素比
+    const Theme* theme;         // 主题（加载后不再修改，可跨线程只读）
+    qint64 inputTimestamp;      // 本帧反映的最早一次输入的时间（纳秒），-1 表示无输入
+    qint64 frameTime;           // 本帧的时间（纳秒），消行动画据此计算进度
+    LineClearEffect lineClears[MAX_LINE_CLEARS];  // 上一帧之后新增的消行效果（定长，不分配内存）
+    int lineClearCount;
+    Block locks[MAX_LOCKS];     // 上一帧之后锁定的方块，用于生成火花
+    int lockCount;
+
+    FrameSnapshot() : fallOffset(0.0f), cellSize(0), devicePixelRatio(1.0), theme(nullptr), inputTimestamp(-1), frameTime(0), lineClearCount(0), lockCount(0) {}
+};
+
+Q_DECLARE_METATYPE(FrameSnapshot)
+
+// 渲染线程中的画面合成
+// 界面线程只负责提交快照和贴图，光栅化在此对象所在的线程中完成
+class RenderWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit RenderWorker(QObject* parent = nullptr);
+
+public slots:
+    void render(const FrameSnapshot& snapshot);
+
+signals:
+    // 画面合成完成（frame 与渲染线程之后的合成互不影响），cellSize 为合成时的格子大小
+    void frameReady(const QImage& frame, int cellSize, qint64 inputTimestamp);
+
+private:
+    FieldRasterizer m_rasterizer;
+    LineClearAnimator m_lineClearAnimator;
+    ParticleSystem m_particles;
+    qint64 m_lastFrameTime;     // 上一帧的时间（纳秒），用于计算粒子的时间步长
+};
+
+#endif // RENDERWORKER_H
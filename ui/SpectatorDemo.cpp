@@ -0,0 +1,99 @@
+#include <QRandomGenerator>
+#include <QDebug>
+#include "SpectatorDemo.h"
+
+SpectatorDemo::SpectatorDemo(SpectatorWidget* view, QObject* parent)
+    : QObject(parent)
+    , m_view(view)
+{
+    m_botTimer.setInterval(BOT_INTERVAL_MS);
+    connect(&m_botTimer, &QTimer::timeout, this, &SpectatorDemo::stepBots);
+}
+
+SpectatorDemo::~SpectatorDemo()
+{
+    stop();
+}
+
+void SpectatorDemo::start(int boardCount)
+{
+    stop();
+
+    for (int i = 0; i < boardCount; ++i) {
+        GameEngine* engine = new GameEngine(this);
+        if (!engine->initialize()) {
+            qWarning() << "Failed to initialize spectator engine" << i;
+            delete engine;
+            continue;
+        }
+        m_engines.append(engine);
+        m_view->addEngine(engine);
+    }
+
+    m_bots.fill(Bot(), m_engines.size());
+    for (int i = 0; i < m_engines.size(); ++i) {
+        m_engines[i]->startGame();
+        chooseTarget(i);
+    }
+
+    m_botTimer.start();
+}
+
+void SpectatorDemo::stop()
+{
+    m_botTimer.stop();
+
+    if (m_view) {
+        m_view->clearEngines();
+    }
+    qDeleteAll(m_engines);
+    m_engines.clear();
+    m_bots.clear();
+}
+
+void SpectatorDemo::chooseTarget(int index)
+{
+    Bot& bot = m_bots[index];
+    bot.turns = QRandomGenerator::global()->bounded(Block::ROT_COUNT);
+    bot.targetX = QRandomGenerator::global()->bounded(m_engines[index]->getGameField().getWidth());
+}
+
+void SpectatorDemo::stepBots()
+{
+    for (int i = 0; i < m_engines.size(); ++i) {
+        GameEngine* engine = m_engines[i];
+
+        if (engine->getGameState() == GameEngine::STATE_GAME_OVER) {
+            engine->restartGame();
+            chooseTarget(i);
+            continue;
+        }
+
+        // 消行等待期间没有当前方块
+        const Block& block = engine->getCurrentBlock();
+        if (engine->getGameState() != GameEngine::STATE_RUNNING || !block.isValid()) {
+            continue;
+        }
+
+        Bot& bot = m_bots[i];
+        const int x = block.getPosition().x;
+
+        if (bot.turns > 0) {
+            engine->rotateClockwise();
+            --bot.turns;
+            continue;
+        }
+
+        // 向目标列移动一格，到达目标列或被挡住时硬降
+        bool moved = false;
+        if (x < bot.targetX) {
+            moved = engine->moveRight();
+        } else if (x > bot.targetX) {
+            moved = engine->moveLeft();
+        }
+        if (!moved) {
+            engine->hardDrop();
+            chooseTarget(i);
+        }
+    }
+}
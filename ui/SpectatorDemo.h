@@ -0,0 +1,47 @@
+#ifndef SPECTATORDEMO_H
+#define SPECTATORDEMO_H
+#include <QObject>
+#include <QPointer>
+#include <QTimer>
+#include <QVector>
+#include "GameEngine.h"
+#include "SpectatorWidget.h"
+
+// 观战演示：运行多局由简单机器人操作的游戏，并显示在观战墙上
+// 机器人每步只做一个操作（旋转、平移或硬降），对局结束后自动重新开始
+class SpectatorDemo : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int DEFAULT_BOARD_COUNT = 64;  // 演示的对局数
+    static constexpr int BOT_INTERVAL_MS = 100;     // 机器人操作间隔
+
+    explicit SpectatorDemo(SpectatorWidget* view, QObject* parent = nullptr);
+    ~SpectatorDemo();
+
+    void start(int boardCount = DEFAULT_BOARD_COUNT);
+    void stop();
+    bool isRunning() const { return !m_engines.isEmpty(); }
+
+private slots:
+    void stepBots();
+
+private:
+    // 单个机器人的目标：旋转次数和目标列
+    struct Bot {
+        int turns;
+        int targetX;
+
+        Bot() : turns(0), targetX(0) {}
+    };
+
+    void chooseTarget(int index);
+
+    QPointer<SpectatorWidget> m_view;   // 观战墙可能先于本对象销毁
+    QVector<GameEngine*> m_engines;
+    QVector<Bot> m_bots;
+    QTimer m_botTimer;
+};
+
+#endif // SPECTATORDEMO_H
@@ -0,0 +1,270 @@
+#include <QPainter>
+#include <QPaintEvent>
+#include <algorithm>
+#include <cstring>
+#include "SpectatorWidget.h"
+
+namespace {
+
+const QRgb WALL_COLOR = qRgb(10, 10, 10);   // 缩略图之间的背景
+const QRgb EMPTY_COLOR = qRgb(20, 20, 20);  // 空格
+
+// 亮度减半（结束的对局）
+inline QRgb dim(QRgb color)
+{
+    return ((color >> 1) & 0x7f7f7f) | 0xff000000;
+}
+
+inline bool samePiece(const Block& a, const Block& b)
+{
+    return a.getPiece() == b.getPiece() && a.getPosition() == b.getPosition() && a.getRotation() == b.getRotation();
+}
+
+} // namespace
+
+SpectatorWidget::SpectatorWidget(QWidget* parent)
+    : QWidget(parent)
+    , m_cellSize(MIN_CELL_SIZE)
+    , m_framePacer(nullptr)
+{
+    // 画面完全由缩略图覆盖，不需要先绘制背景
+    setAttribute(Qt::WA_OpaquePaintEvent);
+
+    m_framePacer = new FramePacer(this);
+    connect(m_framePacer, &FramePacer::frameReady, this, &SpectatorWidget::onFrameReady);
+}
+
+void SpectatorWidget::addEngine(const GameEngine* engine)
+{
+    if (!engine) return;
+
+    Board board;
+    board.engine = engine;
+    m_boards.append(board);
+
+    // 引擎状态变化只请求一帧，同一刷新周期内所有引擎的变化合并绘制
+    connect(engine, &GameEngine::gameFieldChanged, m_framePacer, &FramePacer::requestFrame);
+    connect(engine, &GameEngine::currentBlockChanged, m_framePacer, &FramePacer::requestFrame);
+    connect(engine, &GameEngine::gameStateChanged, m_framePacer, &FramePacer::requestFrame);
+
+    layoutBoards();
+}
+
+void SpectatorWidget::clearEngines()
+{
+    for (const Board& board : std::as_const(m_boards)) {
+        disconnect(board.engine, nullptr, m_framePacer, nullptr);
+    }
+    m_boards.clear();
+
+    layoutBoards();
+}
+
+QSize SpectatorWidget::sizeHint() const
+{
+    // 按 8 列 2 像素格子估算
+    return QSize(8 * (FIELD_WIDTH * 2 + BOARD_SPACING), 4 * (FIELD_HEIGHT * 2 + BOARD_SPACING));
+}
+
+void SpectatorWidget::resizeEvent(QResizeEvent* event)
+{
+    QWidget::resizeEvent(event);
+    layoutBoards();
+}
+
+void SpectatorWidget::paintEvent(QPaintEvent* event)
+{
+    QPainter painter(this);
+
+    // 窗口移到设备像素比不同的屏幕后重新排列
+    if (m_wall.isNull() || !qFuzzyCompare(m_wall.devicePixelRatio(), devicePixelRatioF())) {
+        layoutBoards();
+    }
+
+    // 画面按设备像素绘制，每个重绘矩形贴一次图
+    for (const QRect& rect : event->region()) {
+        painter.drawImage(rect, m_wall, QRectF(rect.topLeft() * m_wall.devicePixelRatio(), rect.size() * m_wall.devicePixelRatio()));
+    }
+}
+
+void SpectatorWidget::layoutBoards()
+{
+    const qreal dpr = devicePixelRatioF();
+    const QSize deviceSize = (QSizeF(size()) * dpr).toSize();
+    if (deviceSize.isEmpty()) return;
+
+    // 各局场地尺寸可能不同，按最大的尺寸分配槽位
+    QSize fieldSize(FIELD_WIDTH, FIELD_HEIGHT);
+    for (const Board& board : std::as_const(m_boards)) {
+        fieldSize = fieldSize.expandedTo(QSize(board.engine->getGameField().getWidth(), board.engine->getGameField().getHeight()));
+    }
+
+    // 选择能放下所有缩略图的最大格子大小（放不下时用最小格子，超出部分不绘制）
+    const int count = qMax(1, m_boards.size());
+    int columns = 1;
+    for (m_cellSize = MAX_CELL_SIZE; m_cellSize >= MIN_CELL_SIZE; --m_cellSize) {
+        const int slotWidth = fieldSize.width() * m_cellSize + BOARD_SPACING;
+        const int slotHeight = fieldSize.height() * m_cellSize + BOARD_SPACING;
+        columns = qBound(1, (deviceSize.width() + BOARD_SPACING) / slotWidth, count);
+        const int rows = (count + columns - 1) / columns;
+        if (rows * slotHeight - BOARD_SPACING <= deviceSize.height() || m_cellSize == MIN_CELL_SIZE) {
+            break;
+        }
+    }
+    m_slotSize = fieldSize * m_cellSize;
+
+    // 整体在控件中居中
+    const int rows = (count + columns - 1) / columns;
+    const QSize gridSize(columns * (m_slotSize.width() + BOARD_SPACING) - BOARD_SPACING,
+                         rows * (m_slotSize.height() + BOARD_SPACING) - BOARD_SPACING);
+    const QPoint offset(qMax(0, (deviceSize.width() - gridSize.width()) / 2),
+                        qMax(0, (deviceSize.height() - gridSize.height()) / 2));
+
+    if (m_wall.size() != deviceSize) {
+        m_wall = QImage(deviceSize, QImage::Format_RGB32);
+    }
+    m_wall.setDevicePixelRatio(dpr);
+    m_wall.fill(WALL_COLOR);
+
+    for (int i = 0; i < m_boards.size(); ++i) {
+        Board& board = m_boards[i];
+        board.origin = offset + QPoint((i % columns) * (m_slotSize.width() + BOARD_SPACING),
+                                       (i / columns) * (m_slotSize.height() + BOARD_SPACING));
+        updateBoard(board, true);
+    }
+
+    update();
+}
+
+void SpectatorWidget::onFrameReady()
+{
+    if (m_wall.isNull()) return;
+
+    const qreal dpr = m_wall.devicePixelRatio();
+    QRegion dirty;
+
+    for (Board& board : m_boards) {
+        const QRect rect = updateBoard(board, false);
+        if (!rect.isEmpty()) {
+            dirty += QRectF(rect.topLeft() / dpr, rect.size() / dpr).toAlignedRect();
+        }
+    }
+
+    if (!dirty.isEmpty()) {
+        update(dirty);
+    }
+}
+
+void SpectatorWidget::pieceRows(const Block& block, int& top, int& bottom)
+{
+    if (!block.isValid()) {
+        top = bottom = 0;
+        return;
+    }
+
+    const QRect& bounds = block.getRotationData().bounds;
+    top = block.getPosition().y + bounds.top();
+    bottom = top + bounds.height();
+}
+
+QRect SpectatorWidget::updateBoard(Board& board, bool force)
+{
+    const GameField& field = board.engine->getGameField();
+    const int width = field.getWidth();
+    const int height = field.getHeight();
+
+    // 超出画面的缩略图不绘制
+    if (!m_wall.rect().contains(QRect(board.origin, QSize(width, height) * m_cellSize))) {
+        return QRect();
+    }
+
+    if (board.rowGenerations.size() != height) {
+        board.rowGenerations.fill(0, height);
+        force = true;
+    }
+
+    const GameEngine::GameState state = board.engine->getGameState();
+    const bool running = state == GameEngine::STATE_RUNNING || state == GameEngine::STATE_PAUSED;
+    if (running != board.running) {
+        board.running = running;
+        force = true;
+    }
+
+    // 方块移动前后覆盖的行都需要重绘
+    int oldTop = 0, oldBottom = 0;
+    int newTop = 0, newBottom = 0;
+    const Block& current = board.engine->getCurrentBlock();
+    if (!samePiece(current, board.piece)) {
+        pieceRows(board.piece, oldTop, oldBottom);
+        board.piece = current;
+        pieceRows(board.piece, newTop, newBottom);
+    }
+
+    int top = height;
+    int bottom = 0;
+    for (int y = 0; y < height; ++y) {
+        const quint64 generation = field.getRowGeneration(y);
+        const bool dirty = force || generation != board.rowGenerations[y]
+                           || (y >= oldTop && y < oldBottom) || (y >= newTop && y < newBottom);
+        if (!dirty) continue;
+
+        board.rowGenerations[y] = generation;
+        drawRow(board, y);
+        top = qMin(top, y);
+        bottom = y + 1;
+    }
+
+    if (top >= bottom) {
+        return QRect();
+    }
+    return QRect(board.origin.x(), board.origin.y() + top * m_cellSize, width * m_cellSize, (bottom - top) * m_cellSize);
+}
+
+void SpectatorWidget::drawRow(const Board& board, int y)
+{
+    const GameField& field = board.engine->getGameField();
+    const int width = field.getWidth();
+    const int cell = m_cellSize;
+    const int rowWidth = width * cell;
+    const int pixelTop = board.origin.y() + y * cell;
+
+    // 当前方块在本行占用的格子
+    quint64 pieceMask = 0;
+    QRgb pieceColor = EMPTY_COLOR;
+    if (board.piece.isValid()) {
+        const PieceSet::Rotation& rotation = board.piece.getRotationData();
+        const int left = board.piece.getPosition().x + rotation.bounds.left();
+        const int row = y - (board.piece.getPosition().y + rotation.bounds.top());
+        if (left >= 0 && row >= 0 && row < rotation.bounds.height()) {
+            pieceMask = rotation.rowMasks[row] << left;
+            pieceColor = board.piece.getColor().rgb();
+        }
+    }
+
+    const quint64 fieldMask = field.getRowMask(y);
+    quint32* line = reinterpret_cast<quint32*>(m_wall.scanLine(pixelTop)) + board.origin.x();
+
+    if ((fieldMask | pieceMask) == 0) {
+        // 空行整行填充
+        std::fill(line, line + rowWidth, board.running ? EMPTY_COLOR : dim(EMPTY_COLOR));
+    } else {
+        for (int x = 0; x < width; ++x) {
+            const quint64 bit = quint64(1) << x;
+            QRgb color = EMPTY_COLOR;
+            if (pieceMask & bit) {
+                color = pieceColor;
+            } else if (fieldMask & bit) {
+                color = field.getCellColor(x, y).rgb();
+            }
+            if (!board.running) {
+                color = dim(color);
+            }
+            std::fill(line + x * cell, line + (x + 1) * cell, color);
+        }
+    }
+
+    // 同一格的其余扫描线与第一条相同
+    for (int i = 1; i < cell; ++i) {
+        std::memcpy(reinterpret_cast<quint32*>(m_wall.scanLine(pixelTop + i)) + board.origin.x(), line, rowWidth * sizeof(quint32));
+    }
+}
@@ -0,0 +1,63 @@
+#ifndef SPECTATORWIDGET_H
+#define SPECTATORWIDGET_H
+#include <QWidget>
+#include <QImage>
+#include <QVector>
+#include <QRegion>
+#include "GameEngine.h"
+#include "FramePacer.h"
+
+// 观战墙：把多局游戏的场地按缩略图绘制到同一张画面中（每格 1-4 个设备像素）
+// 每个刷新周期只重绘行代数变化的行和当前方块移动前后覆盖的行，
+// 每行先按格子颜色写出一条扫描线，再复制到该格的其余扫描线，不经过 QPainter
+class SpectatorWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    static constexpr int MIN_CELL_SIZE = 1;     // 最小格子大小（设备像素）
+    static constexpr int MAX_CELL_SIZE = 4;     // 最大格子大小（设备像素）
+    static constexpr int BOARD_SPACING = 4;     // 缩略图间距（设备像素）
+
+    explicit SpectatorWidget(QWidget* parent = nullptr);
+
+    // 引擎由调用方持有，移除前必须保持有效
+    void addEngine(const GameEngine* engine);
+    void clearEngines();
+    int getBoardCount() const { return m_boards.size(); }
+    int getCellSize() const { return m_cellSize; }
+
+    QSize sizeHint() const override;
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    void resizeEvent(QResizeEvent* event) override;
+
+private slots:
+    void onFrameReady();                    // 到达帧时机，重绘有变化的缩略图
+
+private:
+    // 单个缩略图的绘制状态
+    struct Board {
+        const GameEngine* engine;
+        QPoint origin;                      // 缩略图左上角（设备像素）
+        QVector<quint64> rowGenerations;    // 已绘制的各行代数
+        Block piece;                        // 已绘制的当前方块
+        bool running;                       // 已绘制时游戏是否在进行（结束的对局调暗显示）
+
+        Board() : engine(nullptr), running(false) {}
+    };
+
+    void layoutBoards();                    // 按控件尺寸确定格子大小和排列，并重绘全部缩略图
+    QRect updateBoard(Board& board, bool force);  // 重绘有变化的行，返回重绘区域（设备像素）
+    void drawRow(const Board& board, int y);       // 重绘一行（先写一条扫描线，再复制到其余扫描线）
+    static void pieceRows(const Block& block, int& top, int& bottom);  // 方块覆盖的行范围
+
+    QVector<Board> m_boards;
+    QImage m_wall;                          // 所有缩略图共用的画面（按设备像素比）
+    int m_cellSize;                         // 格子大小（设备像素）
+    QSize m_slotSize;                       // 每个缩略图占用的区域（设备像素，不含间距）
+    FramePacer* m_framePacer;
+};
+
+#endif // SPECTATORWIDGET_H
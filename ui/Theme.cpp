@@ -0,0 +1,158 @@
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDebug>
+#include "Theme.h"
+#include "SimpleIni.h"
+
+// 内置主题数据文件
+static const char* const BUILTIN_THEMES[] = {
+    ":/resources/themes/flat.ini",
+};
+
+// 图集中各行样式的名称，顺序与 CellSpriteCache::Style 一致
+static const char* const STYLE_NAMES[Theme::MAX_STYLES] = {
+    "locked", "active", "ghost", "preview"
+};
+
+Theme::Theme()
+    : m_id("default")
+    , m_name("default")
+    , m_background(20, 20, 20)
+    , m_grid(40, 40, 40)
+    , m_tileSize(0)
+{
+    for (int i = 0; i < MAX_STYLES; ++i) {
+        m_styleRows[i] = -1;
+    }
+}
+
+const Theme* Theme::defaultTheme()
+{
+    return get("default");
+}
+
+const Theme* Theme::get(const QString& nameOrPath)
+{
+    // 已加载的主题常驻内存，图集只解码一次，切换主题时不再读文件
+    static QHash<QString, Theme*> s_cache;
+
+    auto it = s_cache.constFind(nameOrPath);
+    if (it != s_cache.constEnd()) {
+        return it.value();
+    }
+
+    Theme* theme = new Theme();
+    if (nameOrPath != "default") {
+        if (!theme->loadFromFile(nameOrPath)) {
+            qWarning() << "Invalid theme:" << nameOrPath;
+            delete theme;
+            return nullptr;
+        }
+        theme->m_id = nameOrPath;
+    }
+
+    s_cache.insert(nameOrPath, theme);
+    return theme;
+}
+
+QStringList Theme::available()
+{
+    QStringList themes;
+    themes << "default";
+    for (const char* path : BUILTIN_THEMES) {
+        themes << QString::fromLatin1(path);
+    }
+
+    // 工作目录下 themes 目录中的主题
+    QDir dir("themes");
+    const QStringList files = dir.entryList(QStringList() << "*.ini", QDir::Files, QDir::Name);
+    for (const QString& file : files) {
+        themes << dir.filePath(file);
+    }
+
+    return themes;
+}
+
+QRect Theme::tileRect(int style, const QString& pieceName) const
+{
+    if (m_atlas.isNull() || style < 0 || style >= MAX_STYLES || m_styleRows[style] < 0) {
+        return QRect();
+    }
+
+    auto it = m_columns.constFind(pieceName);
+    if (it == m_columns.constEnd()) {
+        return QRect();
+    }
+
+    return QRect(it.value() * m_tileSize, m_styleRows[style] * m_tileSize, m_tileSize, m_tileSize);
+}
+
+bool Theme::loadFromFile(const QString& path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Cannot open theme:" << path;
+        return false;
+    }
+    const QByteArray data = file.readAll();
+
+    CSimpleIniA ini;
+    ini.SetUnicode();
+    if (ini.LoadData(data.constData(), data.size()) < 0) {
+        return false;
+    }
+
+    m_name = QString::fromUtf8(ini.GetValue("Theme", "name", "unnamed"));
+
+    const QColor background(QString::fromUtf8(ini.GetValue("Theme", "background", "")));
+    if (background.isValid()) {
+        m_background = background;
+    }
+    const QColor grid(QString::fromUtf8(ini.GetValue("Theme", "grid", "")));
+    if (grid.isValid()) {
+        m_grid = grid;
+    }
+
+    // 没有图集的主题只改变颜色，格子仍按程序化方式绘制
+    const QString atlasName = QString::fromUtf8(ini.GetValue("Theme", "atlas", ""));
+    if (atlasName.isEmpty()) {
+        return true;
+    }
+
+    m_tileSize = static_cast<int>(ini.GetLongValue("Theme", "tileSize", 0));
+    if (m_tileSize <= 0) {
+        qWarning() << "Invalid tile size in theme" << m_name;
+        return false;
+    }
+
+    const QString atlasPath = QFileInfo(path).dir().filePath(atlasName);
+    QImage atlas(atlasPath);
+    if (atlas.isNull()) {
+        qWarning() << "Cannot load theme atlas:" << atlasPath;
+        return false;
+    }
+    m_atlas = atlas.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+
+    const int columnCount = m_atlas.width() / m_tileSize;
+    const int rowCount = m_atlas.height() / m_tileSize;
+
+    // 各行对应的样式，例如 rows = locked,active,ghost,preview
+    const QStringList rows = QString::fromUtf8(ini.GetValue("Theme", "rows", "locked,active,ghost,preview")).split(',', Qt::SkipEmptyParts);
+    for (int row = 0; row < rows.size() && row < rowCount; ++row) {
+        const QByteArray name = rows[row].trimmed().toUtf8();
+        for (int style = 0; style < MAX_STYLES; ++style) {
+            if (name == STYLE_NAMES[style]) {
+                m_styleRows[style] = row;
+            }
+        }
+    }
+
+    // 各列对应的方块名，例如 pieces = I,O,T,S,Z,J,L
+    const QStringList pieces = QString::fromUtf8(ini.GetValue("Theme", "pieces", "")).split(',', Qt::SkipEmptyParts);
+    for (int column = 0; column < pieces.size() && column < columnCount; ++column) {
+        m_columns.insert(pieces[column].trimmed(), column);
+    }
+
+    return true;
+}
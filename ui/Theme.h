@@ -0,0 +1,55 @@
+#ifndef THEME_H
+#define THEME_H
+#include <QHash>
+#include <QImage>
+#include <QColor>
+#include <QRect>
+#include <QString>
+#include <QStringList>
+
+// 皮肤主题：场地背景色、网格色和一张格子贴图图集
+// 图集每行一种样式（锁定、下落、幽灵、预览），每列一种方块（按方块名对应），
+// 加载主题时解码一次并常驻内存；图集中没有的样式或方块按方块颜色程序化绘制（默认主题没有图集）
+class Theme
+{
+public:
+    static constexpr int MAX_STYLES = 4;  // 图集最多行数，与 CellSpriteCache::Style 一致
+
+    // 默认主题（程序化绘制）
+    static const Theme* defaultTheme();
+
+    // 按名称或路径获取主题（"default" 为默认主题），加载失败时返回 nullptr
+    // 已加载的主题会被缓存，在程序生命周期内保持有效；只在界面线程中调用
+    static const Theme* get(const QString& nameOrPath);
+
+    // 可选的主题：默认主题、内置主题和 themes 目录中的主题数据文件
+    static QStringList available();
+
+    // 属性获取
+    const QString& getId() const { return m_id; }       // 获取主题时使用的名称或路径
+    const QString& getName() const { return m_name; }   // 显示名称
+    QColor getBackgroundColor() const { return m_background; }
+    QColor getGridColor() const { return m_grid; }
+    bool hasAtlas() const { return !m_atlas.isNull(); }
+    const QImage& getAtlas() const { return m_atlas; }
+
+    // 图集中某样式、某方块的贴图区域，没有时返回空矩形
+    QRect tileRect(int style, const QString& pieceName) const;
+
+private:
+    Theme();
+
+    // 从 ini 格式数据文件加载，图集路径相对于数据文件
+    bool loadFromFile(const QString& path);
+
+    QString m_id;
+    QString m_name;
+    QColor m_background;
+    QColor m_grid;
+    QImage m_atlas;                 // 解码后的图集（ARGB32_Premultiplied）
+    int m_tileSize;                 // 图集中每格的像素大小
+    int m_styleRows[MAX_STYLES];    // 每种样式在图集中的行号，-1 表示没有
+    QHash<QString, int> m_columns;  // 方块名对应的列号
+};
+
+#endif // THEME_H